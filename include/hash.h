@@ -18,6 +18,19 @@
  *     void ht_destroy_free_keys(HT_TABLE *table);
  *     size_t ht_count(const HT_TABLE *table);
  *     void ht_iterate(HT_TABLE *table, ht_iterator_fn callback, void *user_data);
+ *     void ht_stats(const HT_TABLE *table, HT_STATS *stats);
+ *
+ *     HT_DEFINE(name, key_t, val_t, hash_fn, eq_fn)
+ *     int name_init(name_t *t, size_t initial_size);
+ *     int name_reserve(name_t *t, size_t n);
+ *     int name_rehash(name_t *t, size_t new_size);
+ *     val_t *name_get(const name_t *t, key_t key);
+ *     val_t *name_put(name_t *t, key_t key, val_t value);
+ *     int name_remove(name_t *t, key_t key);
+ *     int name_next(const name_t *t, size_t *pos, key_t *key, val_t **value);
+ *     size_t name_count(const name_t *t);
+ *     void name_clear(name_t *t);
+ *     void name_free(name_t *t);
  *
  * DESCRIPTION
  *     These functions provide a portable, high-performance hash table
@@ -38,12 +51,15 @@
  *         HT_ENTER  - Insert a new entry or update an existing one
  *
  *     Returns a pointer to the found or inserted entry, or NULL if not found
- *     (when action is HT_FIND) or on allocation failure.
+ *     (when action is HT_FIND) or on allocation failure. Insertions and
+ *     deletions move entries, so the pointer is only valid until the next
+ *     HT_ENTER of a new key or ht_delete() on the same table.
  *
- *     ht_delete() removes the entry with the specified key from the table.
- *     Returns 1 if the entry was found and deleted, 0 otherwise. The key and
- *     data pointers are not freed; the caller is responsible for memory
- *     management.
+ *     ht_delete() removes the entry with the specified key from the table
+ *     and shifts the rest of its run back by one bucket (no tombstones, no
+ *     re-insertion). Returns 1 if the entry was found and deleted, 0
+ *     otherwise. The key and data pointers are not freed; the caller is
+ *     responsible for memory management.
  *
  *     ht_destroy() frees all memory associated with the hash table, including
  *     the table structure itself. This function does NOT free the keys or
@@ -59,6 +75,48 @@
  *     table. The callback receives the key, data, and user_data parameters.
  *     The iteration order is unspecified.
  *
+ *     ht_stats() walks the table and fills stats with its occupancy, the
+ *     histogram of probe lengths for successful searches (one per stored
+ *     key) and unsuccessful searches (one per home slot), the longest run
+ *     of occupied slots, and the expected cache misses per lookup on a
+ *     cold cache (bucket lines touched plus the key dereference for the
+ *     comparison).
+ *
+ * TYPED TABLES
+ *     HT_DEFINE() generates a table specialized for one key and value type,
+ *     for keys that are not strings (64-bit hashes, word ids). Keys, values
+ *     and one byte of probe distance per bucket live in three parallel
+ *     arrays, so a probe reads no pointers and calls no strcmp(); the same
+ *     Robin Hood insertion and backward-shift deletion are used.
+ *
+ *     hash_fn(key) returns an integer whose low bits are well mixed; eq_fn(a,
+ *     b) returns nonzero for equal keys. Provided: ht_hash_identity_u64()
+ *     for keys that already are hashes, ht_hash_mix_u64() for sequential
+ *     integers, ht_hash_xxh3_u64() when xxh3.h is included first, and
+ *     ht_eq_u64() / ht_eq_u32().
+ *
+ *     name_init() accepts initial_size 0 (nothing is allocated until the
+ *     first put). name_reserve() makes room for n keys so no rehash happens
+ *     while they are inserted; name_rehash() rebuilds with at least new_size
+ *     buckets. name_get() and name_put() return a pointer to the stored
+ *     value, valid until the next put of a new key or remove; name_put()
+ *     returns NULL only on allocation failure. name_next() iterates from
+ *     *pos = 0 and returns 0 when done. init, reserve, rehash return 0 on
+ *     allocation failure.
+ *
+ *         HT_DEFINE(id_map, uint64_t, uint32_t, ht_hash_identity_u64, ht_eq_u64)
+ *
+ *         id_map_t map;
+ *         id_map_init(&map, 0);
+ *         id_map_put(&map, xxh3(word, len), word_id);
+ *         uint32_t *id = id_map_get(&map, xxh3(query, qlen));
+ *
+ *         size_t pos = 0;
+ *         uint64_t key;
+ *         uint32_t *value;
+ *         while (id_map_next(&map, &pos, &key, &value)) { ... }
+ *         id_map_free(&map);
+ *
  * STRUCTURES
  *     typedef struct {
  *         char *key;
@@ -88,7 +146,13 @@
  *     - Keys are stored as pointers, not copied. The caller must ensure keys
  *       remain valid for the lifetime of the hash table entry.
  *     - The hash table automatically resizes when the load factor exceeds 75%.
- *     - All functions use linear probing for collision resolution.
+ *     - Collisions are resolved by linear probing in Robin Hood order: an
+ *       insertion takes the bucket of any resident closer to its home than
+ *       the new key is to its own, which keeps probe lengths even and lets
+ *       an unsuccessful search stop at the first such bucket instead of at
+ *       the end of the run.
+ *     - Each bucket stores the 32-bit hash and the key length; the key bytes
+ *       are only compared when both match. Keys must be shorter than 2 GiB.
  *     - The implementation uses FNV-1a hashing for good distribution.
  *     - All functions are inline for maximum performance.
  *     - Thread safety: Multiple threads can safely operate on different
@@ -131,7 +195,8 @@
  * CONFIGURATION
  *     The following macros can be defined before including this header:
  *
- *     HT_INITIAL_SIZE - Default initial size (default: 32)
+ *     HT_INITIAL_SIZE - Default initial size, rounded up to a power of two
+ *                       (default: 32)
  *     HT_LOAD_FACTOR  - Resize threshold (default: 0.75)
  *
  * SEE ALSO
@@ -176,7 +241,8 @@ typedef struct {
     char *key;
     void *data;
     uint32_t hash;
-    int occupied;
+    uint32_t key_len : 31;      /* strlen(key), compared before the bytes */
+    uint32_t occupied : 1;
 } HT_BUCKET;
 
 /* Hash table structure */
@@ -196,6 +262,23 @@ static inline uint32_t ht_hash(const char *key) {
     return hash;
 }
 
+/* FNV-1a that also returns the key length, so lookups need no strlen() */
+static inline uint32_t ht_hash_len(const char *key, size_t *len) {
+    const char *p = key;
+    uint32_t hash = 2166136261u;
+    while (*p) {
+        hash ^= (uint8_t)*p++;
+        hash *= 16777619u;
+    }
+    *len = (size_t)(p - key);
+    return hash;
+}
+
+/* Distance of the bucket at idx from its home bucket */
+static inline size_t ht_probe_distance(const HT_TABLE *table, size_t idx) {
+    return (idx - (table->buckets[idx].hash & (table->size - 1))) & (table->size - 1);
+}
+
 /* Create a new hash table */
 static inline HT_TABLE *ht_create(size_t initial_size) {
     if (initial_size == 0) {
@@ -222,6 +305,34 @@ static inline HT_TABLE *ht_create(size_t initial_size) {
     return table;
 }
 
+/*
+ * Robin Hood placement of a key known to be absent, starting at idx with
+ * probe distance dist: the incoming bucket takes the slot of the first
+ * resident that is closer to its home, which then moves on in its place.
+ * Returns the index where the original bucket landed.
+ */
+static inline size_t ht_place(HT_TABLE *table, HT_BUCKET incoming, size_t idx, size_t dist) {
+    size_t mask = table->size - 1;
+    size_t landed = table->size;
+    
+    while (table->buckets[idx].occupied) {
+        size_t resident_dist = ht_probe_distance(table, idx);
+        if (resident_dist < dist) {
+            HT_BUCKET displaced = table->buckets[idx];
+            table->buckets[idx] = incoming;
+            if (landed == table->size) landed = idx;
+            incoming = displaced;
+            dist = resident_dist;
+        }
+        idx = (idx + 1) & mask;
+        dist++;
+    }
+    table->buckets[idx] = incoming;
+    if (landed == table->size) landed = idx;
+    table->count++;
+    return landed;
+}
+
 /* Resize hash table */
 static inline int ht_resize(HT_TABLE *table, size_t new_size) {
     HT_BUCKET *old_buckets = table->buckets;
@@ -239,16 +350,7 @@ static inline int ht_resize(HT_TABLE *table, size_t new_size) {
     /* Rehash all entries */
     for (size_t i = 0; i < old_size; i++) {
         if (old_buckets[i].occupied) {
-            uint32_t hash = old_buckets[i].hash;
-            size_t idx = hash & (new_size - 1);
-            
-            /* Linear probing */
-            while (table->buckets[idx].occupied) {
-                idx = (idx + 1) & (new_size - 1);
-            }
-            
-            table->buckets[idx] = old_buckets[i];
-            table->count++;
+            ht_place(table, old_buckets[i], old_buckets[i].hash & (new_size - 1), 0);
         }
     }
     
@@ -256,96 +358,93 @@ static inline int ht_resize(HT_TABLE *table, size_t new_size) {
     return 1;
 }
 
+/*
+ * Index of the bucket holding key, or table->size if absent. A search
+ * stops at an empty bucket or at one closer to its home than the search
+ * is to the key's home: Robin Hood order guarantees the key is not further
+ * on. *stop receives the bucket index and *stop_dist the probe distance
+ * where the search ended, which is where an insertion has to start.
+ */
+static inline size_t ht_find_index(const HT_TABLE *table, const char *key, uint32_t hash,
+                                   size_t len, size_t *stop, size_t *stop_dist) {
+    const HT_BUCKET *buckets = table->buckets;
+    size_t mask = table->size - 1;
+    size_t idx = hash & mask;
+    size_t dist = 0;
+    
+    while (buckets[idx].occupied) {
+        const HT_BUCKET *bucket = &buckets[idx];
+        if (bucket->hash == hash && bucket->key_len == len &&
+            memcmp(bucket->key, key, len) == 0) {
+            return idx;
+        }
+        if (((idx - (bucket->hash & mask)) & mask) < dist) break;
+        
+        idx = (idx + 1) & mask;
+        dist++;
+    }
+    if (stop) *stop = idx;
+    if (stop_dist) *stop_dist = dist;
+    return table->size;
+}
+
 /* Search or insert entry */
 static inline HT_ENTRY *ht_search(HT_TABLE *table, HT_ENTRY item, HT_ACTION action) {
     if (!table || !item.key) return NULL;
     
-    /* Check if resize needed */
-    if (action == HT_ENTER && 
-        (double)table->count / table->size >= HT_LOAD_FACTOR) {
-        if (!ht_resize(table, table->size * 2)) {
-            return NULL;
+    size_t len;
+    uint32_t hash = ht_hash_len(item.key, &len);
+    if (len > 0x7fffffffu) return NULL;
+    
+    size_t stop = 0, stop_dist = 0;
+    size_t idx = ht_find_index(table, item.key, hash, len, &stop, &stop_dist);
+    if (idx != table->size) {
+        if (action == HT_ENTER) {
+            /* Update existing entry */
+            table->buckets[idx].data = item.data;
         }
+        return (HT_ENTRY *)&table->buckets[idx];
     }
+    if (action != HT_ENTER) return NULL;
     
-    uint32_t hash = ht_hash(item.key);
-    size_t idx = hash & (table->size - 1);
-    size_t start_idx = idx;
-    
-    /* Linear probing */
-    while (1) {
-        HT_BUCKET *bucket = &table->buckets[idx];
-        
-        if (!bucket->occupied) {
-            if (action == HT_ENTER) {
-                /* Insert new entry */
-                bucket->key = item.key;
-                bucket->data = item.data;
-                bucket->hash = hash;
-                bucket->occupied = 1;
-                table->count++;
-                return (HT_ENTRY *)bucket;
-            }
-            return NULL;
-        }
-        
-        /* Check if keys match */
-        if (bucket->hash == hash && strcmp(bucket->key, item.key) == 0) {
-            if (action == HT_ENTER) {
-                /* Update existing entry */
-                bucket->data = item.data;
-            }
-            return (HT_ENTRY *)bucket;
-        }
-        
-        idx = (idx + 1) & (table->size - 1);
-        
-        /* Table full (shouldn't happen with proper load factor) */
-        if (idx == start_idx) {
+    /* Check if resize needed; the search position is stale after one */
+    if ((double)(table->count + 1) / table->size > HT_LOAD_FACTOR) {
+        if (!ht_resize(table, table->size * 2)) {
             return NULL;
         }
+        stop = hash & (table->size - 1);
+        stop_dist = 0;
     }
+    
+    HT_BUCKET bucket;
+    bucket.key = item.key;
+    bucket.data = item.data;
+    bucket.hash = hash;
+    bucket.key_len = (uint32_t)len;
+    bucket.occupied = 1;
+    return (HT_ENTRY *)&table->buckets[ht_place(table, bucket, stop, stop_dist)];
 }
 
 /* Delete entry from hash table */
 static inline int ht_delete(HT_TABLE *table, const char *key) {
     if (!table || !key) return 0;
     
-    uint32_t hash = ht_hash(key);
-    size_t idx = hash & (table->size - 1);
-    size_t start_idx = idx;
+    size_t len;
+    uint32_t hash = ht_hash_len(key, &len);
+    size_t idx = ht_find_index(table, key, hash, len, NULL, NULL);
+    if (idx == table->size) return 0;
     
-    while (table->buckets[idx].occupied) {
-        HT_BUCKET *bucket = &table->buckets[idx];
-        
-        if (bucket->hash == hash && strcmp(bucket->key, key) == 0) {
-            /* Mark as deleted */
-            bucket->occupied = 0;
-            bucket->key = NULL;
-            bucket->data = NULL;
-            table->count--;
-            
-            /* Rehash subsequent entries in the cluster */
-            size_t next_idx = (idx + 1) & (table->size - 1);
-            while (table->buckets[next_idx].occupied) {
-                HT_BUCKET temp = table->buckets[next_idx];
-                table->buckets[next_idx].occupied = 0;
-                table->count--;
-                
-                HT_ENTRY item = {temp.key, temp.data};
-                ht_search(table, item, HT_ENTER);
-                
-                next_idx = (next_idx + 1) & (table->size - 1);
-            }
-            
-            return 1;
-        }
-        
-        idx = (idx + 1) & (table->size - 1);
-        if (idx == start_idx) break;
+    /* Backward shift: pull the rest of the run one bucket closer to home */
+    size_t mask = table->size - 1;
+    size_t next = (idx + 1) & mask;
+    while (table->buckets[next].occupied && ht_probe_distance(table, next) > 0) {
+        table->buckets[idx] = table->buckets[next];
+        idx = next;
+        next = (next + 1) & mask;
     }
-    
-    return 0;
+    memset(&table->buckets[idx], 0, sizeof(HT_BUCKET));
+    table->count--;
+    return 1;
 }
 
 /* Destroy hash table (does not free keys/data) */
@@ -387,4 +486,318 @@ static inline void ht_iterate(HT_TABLE *table, ht_iterator_fn callback, void *us
     }
 }
 
+/* Probe statistics */
+#ifndef HT_STATS_HISTOGRAM_SIZE
+#define HT_STATS_HISTOGRAM_SIZE 32
+#endif
+
+typedef struct {
+    size_t size;
+    size_t count;
+    double load_factor;
+    size_t clusters;                               /* Runs of occupied buckets */
+    size_t longest_cluster;
+    uint64_t hit_probes[HT_STATS_HISTOGRAM_SIZE];  /* [k]: found after k+1 probes */
+    uint64_t miss_probes[HT_STATS_HISTOGRAM_SIZE]; /* [k]: miss after k+1 probes */
+    size_t max_hit_probes;
+    size_t max_miss_probes;
+    double mean_hit_probes;
+    double mean_miss_probes;
+    double expected_hit_misses;                    /* Cold-cache misses per hit */
+    double expected_miss_misses;                   /* Cold-cache misses per miss */
+} HT_STATS;
+
+/* Cache lines covered by k buckets starting at idx (wrapping) */
+static inline size_t ht_probe_lines(const HT_TABLE *table, size_t idx, size_t k) {
+    size_t lines = 0;
+    while (k > 0) {
+        size_t run = (idx + k <= table->size) ? k : table->size - idx;
+        size_t first = idx * sizeof(HT_BUCKET) / 64;
+        size_t last = ((idx + run) * sizeof(HT_BUCKET) - 1) / 64;
+        lines += last - first + 1;
+        k -= run;
+        idx = 0;
+    }
+    return lines;
+}
+
+/* Walk the table and collect probe-length and clustering statistics */
+static inline void ht_stats(const HT_TABLE *table, HT_STATS *stats) {
+    if (!stats) return;
+    memset(stats, 0, sizeof(*stats));
+    if (!table || table->size == 0) return;
+
+    size_t size = table->size;
+    size_t mask = size - 1;
+    stats->size = size;
+    stats->count = table->count;
+    stats->load_factor = (double)table->count / (double)size;
+
+    size_t first_empty = size;
+    double hit_total = 0, hit_misses = 0;
+    for (size_t i = 0; i < size; i++) {
+        const HT_BUCKET *bucket = &table->buckets[i];
+        if (!bucket->occupied) {
+            if (first_empty == size) first_empty = i;
+            continue;
+        }
+        size_t home = bucket->hash & mask;
+        size_t probes = ((i - home) & mask) + 1;
+        size_t b = probes - 1 < HT_STATS_HISTOGRAM_SIZE ? probes - 1 : HT_STATS_HISTOGRAM_SIZE - 1;
+        stats->hit_probes[b]++;
+        if (probes > stats->max_hit_probes) stats->max_hit_probes = probes;
+        hit_total += (double)probes;
+        hit_misses += (double)(ht_probe_lines(table, home, probes) + 1);
+    }
+    if (table->count) {
+        stats->mean_hit_probes = hit_total / (double)table->count;
+        stats->expected_hit_misses = hit_misses / (double)table->count;
+    }
+    if (first_empty == size) return;
+
+    /* Runs of occupied buckets, walking back from an empty one */
+    size_t run = 0;
+    for (size_t n = 0; n < size; n++) {
+        size_t i = (first_empty - n) & mask;
+        if (!table->buckets[i].occupied) {
+            if (run > 0) {
+                stats->clusters++;
+                if (run > stats->longest_cluster) stats->longest_cluster = run;
+            }
+            run = 0;
+        } else {
+            run++;
+        }
+    }
+    if (run > 0) {
+        stats->clusters++;
+        if (run > stats->longest_cluster) stats->longest_cluster = run;
+    }
+
+    /* A miss from home i ends at an empty bucket or a bucket closer to its home */
+    double miss_total = 0, miss_misses = 0;
+    for (size_t i = 0; i < size; i++) {
+        size_t k = 0;
+        while (table->buckets[(i + k) & mask].occupied &&
+               ht_probe_distance(table, (i + k) & mask) >= k) {
+            k++;
+        }
+        size_t probes = k + 1;
+        size_t b = k < HT_STATS_HISTOGRAM_SIZE ? k : HT_STATS_HISTOGRAM_SIZE - 1;
+        stats->miss_probes[b]++;
+        if (probes > stats->max_miss_probes) stats->max_miss_probes = probes;
+        miss_total += (double)probes;
+        miss_misses += (double)ht_probe_lines(table, i, probes);
+    }
+    stats->mean_miss_probes = miss_total / (double)size;
+    stats->expected_miss_misses = miss_misses / (double)size;
+}
+
+/*
+ * Typed tables
+ *
+ * HT_DEFINE(name, key_t, val_t, hash_fn, eq_fn) emits name_t and its
+ * functions for keys and values stored by value. hash_fn(key) returns an
+ * integer hash (only the low bits pick the home bucket, so it must mix
+ * them); eq_fn(a, b) returns nonzero when two keys are equal.
+ */
+
+/* Identity hash for keys that already are hashes (e.g. xxh3 of a string) */
+static inline uint64_t ht_hash_identity_u64(uint64_t key) {
+    return key;
+}
+
+/* Full avalanche of an integer key (xxh3's final mix, for sequential ids) */
+static inline uint64_t ht_hash_mix_u64(uint64_t key) {
+    key ^= key >> 37;
+    key *= 0x165667919E3779F9ULL;
+    key ^= key >> 32;
+    return key;
+}
+
+#ifdef XXH3_H
+/* xxh3 of the key bytes, when xxh3.h is included before this header */
+static inline uint64_t ht_hash_xxh3_u64(uint64_t key) {
+    return xxh3(&key, sizeof(key));
+}
+#endif
+
+static inline int ht_eq_u64(uint64_t a, uint64_t b) {
+    return a == b;
+}
+
+static inline int ht_eq_u32(uint32_t a, uint32_t b) {
+    return a == b;
+}
+
+/* Probe distances are stored saturated; longer ones are recomputed from the key */
+#define HT_TYPED_DIST_SATURATED 255
+
+#define HT_DEFINE(name, key_t, val_t, hash_fn, eq_fn)                          \
+                                                                               \
+typedef struct {                                                               \
+    key_t *keys;                                                               \
+    val_t *values;                                                             \
+    uint8_t *dists;             /* Probe distance + 1, 0 when empty */         \
+    size_t size;                /* Power of 2, 0 before the first insert */    \
+    size_t count;                                                              \
+} name##_t;                                                                    \
+                                                                               \
+static inline int name##_rehash(name##_t *t, size_t new_size);                 \
+                                                                               \
+static inline int name##_init(name##_t *t, size_t initial_size) {              \
+    memset(t, 0, sizeof(*t));                                                  \
+    return initial_size ? name##_rehash(t, initial_size) : 1;                  \
+}                                                                              \
+                                                                               \
+static inline void name##_free(name##_t *t) {                                  \
+    free(t->keys);                                                             \
+    free(t->values);                                                           \
+    free(t->dists);                                                            \
+    memset(t, 0, sizeof(*t));                                                  \
+}                                                                              \
+                                                                               \
+static inline void name##_clear(name##_t *t) {                                 \
+    if (t->dists) memset(t->dists, 0, t->size);                                \
+    t->count = 0;                                                              \
+}                                                                              \
+                                                                               \
+static inline size_t name##_count(const name##_t *t) {                         \
+    return t->count;                                                           \
+}                                                                              \
+                                                                               \
+/* Probe distance + 1 of the occupied bucket idx */                           \
+static inline size_t name##_dist(const name##_t *t, size_t idx) {              \
+    size_t d = t->dists[idx];                                                  \
+    if (d < HT_TYPED_DIST_SATURATED) return d;                                 \
+    size_t mask = t->size - 1;                                                 \
+    return ((idx - ((size_t)(hash_fn(t->keys[idx])) & mask)) & mask) + 1;      \
+}                                                                              \
+                                                                               \
+static inline void name##_set(name##_t *t, size_t idx, key_t key, val_t value, \
+                              size_t dist) {                                   \
+    t->keys[idx] = key;                                                        \
+    t->values[idx] = value;                                                    \
+    t->dists[idx] = (uint8_t)(dist < HT_TYPED_DIST_SATURATED                   \
+                              ? dist : HT_TYPED_DIST_SATURATED);               \
+}                                                                              \
+                                                                               \
+/* Robin Hood placement of an absent key; returns where it landed */          \
+static inline size_t name##_place(name##_t *t, key_t key, val_t value) {       \
+    size_t mask = t->size - 1;                                                 \
+    size_t idx = (size_t)(hash_fn(key)) & mask;                                \
+    size_t dist = 1;                                                           \
+    size_t landed = t->size;                                                   \
+    while (t->dists[idx]) {                                                    \
+        size_t resident = name##_dist(t, idx);                                 \
+        if (resident < dist) {                                                 \
+            key_t k = t->keys[idx];                                            \
+            val_t v = t->values[idx];                                          \
+            name##_set(t, idx, key, value, dist);                              \
+            if (landed == t->size) landed = idx;                               \
+            key = k;                                                           \
+            value = v;                                                         \
+            dist = resident;                                                   \
+        }                                                                      \
+        idx = (idx + 1) & mask;                                                \
+        dist++;                                                                \
+    }                                                                          \
+    name##_set(t, idx, key, value, dist);                                      \
+    t->count++;                                                                \
+    return landed == t->size ? idx : landed;                                   \
+}                                                                              \
+                                                                               \
+/* Rebuild with at least new_size buckets (and room for the current keys);  \
+ * the size is a power of two whatever HT_INITIAL_SIZE is, as probing masks */ \
+static inline int name##_rehash(name##_t *t, size_t new_size) {                \
+    size_t size = 1;                                                           \
+    while (size < HT_INITIAL_SIZE || size < new_size ||                        \
+           (double)t->count / size > HT_LOAD_FACTOR) {                         \
+        size <<= 1;                                                            \
+    }                                                                          \
+    name##_t grown;                                                            \
+    memset(&grown, 0, sizeof(grown));                                          \
+    grown.keys = (key_t *)malloc(size * sizeof(key_t));                        \
+    grown.values = (val_t *)malloc(size * sizeof(val_t));                      \
+    grown.dists = (uint8_t *)calloc(size, 1);                                  \
+    grown.size = size;                                                         \
+    if (!grown.keys || !grown.values || !grown.dists) {                        \
+        name##_free(&grown);                                                   \
+        return 0;                                                              \
+    }                                                                          \
+    for (size_t i = 0; i < t->size; i++) {                                     \
+        if (t->dists[i]) name##_place(&grown, t->keys[i], t->values[i]);       \
+    }                                                                          \
+    name##_free(t);                                                            \
+    *t = grown;                                                                \
+    return 1;                                                                  \
+}                                                                              \
+                                                                               \
+/* Make room for n keys without further rehashing */                          \
+static inline int name##_reserve(name##_t *t, size_t n) {                      \
+    if ((double)n <= HT_LOAD_FACTOR * t->size) return 1;                       \
+    return name##_rehash(t, (size_t)((double)n / HT_LOAD_FACTOR) + 1);         \
+}                                                                              \
+                                                                               \
+static inline size_t name##_find(const name##_t *t, key_t key) {               \
+    if (t->count == 0) return t->size;                                         \
+    size_t mask = t->size - 1;                                                 \
+    size_t idx = (size_t)(hash_fn(key)) & mask;                                \
+    for (size_t dist = 1; t->dists[idx] >= dist ||                             \
+         (t->dists[idx] == HT_TYPED_DIST_SATURATED &&                          \
+          name##_dist(t, idx) >= dist); dist++) {                              \
+        if (eq_fn(t->keys[idx], key)) return idx;                              \
+        idx = (idx + 1) & mask;                                                \
+    }                                                                          \
+    return t->size;                                                            \
+}                                                                              \
+                                                                               \
+/* Pointer to the value of key, or NULL; valid until the next put/remove */   \
+static inline val_t *name##_get(const name##_t *t, key_t key) {                \
+    size_t idx = name##_find(t, key);                                          \
+    return idx == t->size ? NULL : &t->values[idx];                            \
+}                                                                              \
+                                                                               \
+/* Insert or update; returns the stored value, or NULL on allocation failure */ \
+static inline val_t *name##_put(name##_t *t, key_t key, val_t value) {         \
+    size_t idx = name##_find(t, key);                                          \
+    if (idx != t->size) {                                                      \
+        t->values[idx] = value;                                                \
+        return &t->values[idx];                                                \
+    }                                                                          \
+    if (!name##_reserve(t, t->count + 1)) return NULL;                         \
+    return &t->values[name##_place(t, key, value)];                            \
+}                                                                              \
+                                                                               \
+/* Remove key with backward-shift deletion; returns 1 if it was present */    \
+static inline int name##_remove(name##_t *t, key_t key) {                      \
+    size_t idx = name##_find(t, key);                                          \
+    if (idx == t->size) return 0;                                              \
+    size_t mask = t->size - 1;                                                 \
+    size_t next = (idx + 1) & mask;                                            \
+    while (t->dists[next] > 1) {                                               \
+        name##_set(t, idx, t->keys[next], t->values[next],                     \
+                   name##_dist(t, next) - 1);                                  \
+        idx = next;                                                            \
+        next = (next + 1) & mask;                                              \
+    }                                                                          \
+    t->dists[idx] = 0;                                                         \
+    t->count--;                                                                \
+    return 1;                                                                  \
+}                                                                              \
+                                                                               \
+/* Iterate: size_t pos = 0; while (name_next(t, &pos, &k, &v)) { ... } */     \
+static inline int name##_next(const name##_t *t, size_t *pos, key_t *key,      \
+                              val_t **value) {                                 \
+    while (*pos < t->size) {                                                   \
+        size_t i = (*pos)++;                                                   \
+        if (t->dists[i]) {                                                     \
+            if (key) *key = t->keys[i];                                        \
+            if (value) *value = &t->values[i];                                 \
+            return 1;                                                          \
+        }                                                                      \
+    }                                                                          \
+    return 0;                                                                  \
+}
+
 #endif /* HASH_H */
@@ -31,6 +31,12 @@
  *     int c_asprintf(char **strp, const char *fmt, ...);
  *     ssize_t c_getline(char **lineptr, size_t *n, FILE *stream);
  *
+ *     c_reader_t *c_reader_open(FILE *stream);
+ *     c_reader_t *c_reader_open_fd(int fd);
+ *     char *c_reader_next_line(c_reader_t *reader, size_t *len);
+ *     int c_reader_error(const c_reader_t *reader);
+ *     void c_reader_close(c_reader_t *reader);
+ *
  * DESCRIPTION
  *     These functions provide portable C99 implementations of common POSIX
  *     string and memory utilities.
@@ -62,7 +68,21 @@
  *
  *     c_getline() reads an entire line from stream, storing the address of
  *     the buffer in *lineptr and the size in *n. The buffer is automatically
- *     resized if needed.
+ *     resized if needed. Null bytes inside the line are kept, so use the
+ *     return value rather than strlen(3) for its length.
+ *
+ *     c_reader_open() wraps stream in a line reader with its own
+ *     C_READER_BUFFER_SIZE byte buffer, filled with large fread(3) calls.
+ *     c_reader_open_fd() does the same over read(2) on a file descriptor
+ *     and is only available when _POSIX_C_SOURCE is defined. Neither takes
+ *     ownership: close the stream or descriptor after c_reader_close().
+ *
+ *     c_reader_next_line() returns the next line as a view into the
+ *     reader's buffer. The trailing newline (and a carriage return before
+ *     it) is replaced by a null byte and *len, if len is non-NULL, is set
+ *     to the length without it. The view stays valid, and may be modified
+ *     in place, until the next call on the same reader. Newlines are found
+ *     with memchr(3); the buffer grows for lines longer than it.
  *
  * RETURN VALUE
  *     c_strdup() and c_strndup() return a pointer to the duplicated string,
@@ -83,10 +103,17 @@
  *     c_getline() returns the number of characters read (including newline
  *     but excluding null byte), or -1 on error or EOF.
  *
+ *     c_reader_open() and c_reader_open_fd() return a new reader, or NULL
+ *     if insufficient memory was available. c_reader_next_line() returns
+ *     NULL at end of input or on error; c_reader_error() then tells them
+ *     apart (non-zero after a read or allocation error).
+ *
  * NOTES
  *     All allocation functions use malloc() and can be freed with free().
  *     These functions are thread-safe if the underlying C library functions
- *     (malloc, strcpy, etc.) are thread-safe.
+ *     (malloc, strcpy, etc.) are thread-safe. They keep no static state; a
+ *     c_reader_t must not be shared between threads, but separate readers
+ *     can be used concurrently.
  *
  * EXAMPLES
  *     Duplicate a string:
@@ -109,6 +136,15 @@
  *         }
  *         free(str);
  *
+ *     Read a file line by line:
+ *         c_reader_t *reader = c_reader_open(fp);
+ *         size_t len;
+ *         char *line;
+ *         while (reader && (line = c_reader_next_line(reader, &len))) {
+ *             printf("%zu: %s\n", len, line);
+ *         }
+ *         c_reader_close(reader);
+ *
  * SEE ALSO
  *     strdup(3), strcasecmp(3), strsep(3), getline(3)
  * ============================================================================
@@ -126,8 +162,9 @@
 #include <stdarg.h>
 #include <stdint.h>
 #include <limits.h>
+#include <errno.h>
 
-#define GETLINE_BUFFER_SIZE 4096
+#define C_READER_BUFFER_SIZE (64 * 1024)
 
 /* ============================================================================
  * Platform Detection
@@ -142,6 +179,7 @@
 /* Include POSIX strings.h early if available */
 #if defined(_POSIX_C_SOURCE)
     #include <strings.h>
+    #include <unistd.h>
 #endif
 
 /* Define ssize_t if not available (Windows) */
@@ -499,86 +537,226 @@ static inline int c_asprintf(char** strp, const char* fmt, ...) {
     va_end(ap_copy);
     
     return result;
-#endif
 }
 
 /* ============================================================================
  * Line-Oriented Input
  * ============================================================================ */
 
+/**
+ * c_getline - Read a line, growing the buffer as needed
+ * @lineptr: Pointer to a malloc()ed buffer or NULL
+ * @n: Pointer to the buffer size
+ * @stream: Stream to read from
+ *
+ * Returns: Characters read (including newline), or -1 on error or EOF
+ */
 static inline ssize_t c_getline(char** lineptr, size_t* n, FILE* stream) {
-#if defined(_POSIX_C_SOURCE)
+#if defined(_POSIX_C_SOURCE) && _POSIX_C_SOURCE >= 200809L
     return getline(lineptr, n, stream);
 #else
     if (!lineptr || !n || !stream) return -1;
     
-    if (*lineptr == NULL || *n == 0) {
+    if (*lineptr == NULL || *n < 2) {
+        char* new_ptr = realloc(*lineptr, 128);
+        if (!new_ptr) return -1;
+        *lineptr = new_ptr;
         *n = 128;
-        *lineptr = malloc(*n);
-        if (!*lineptr) return -1;
     }
     
-    /* Static buffers allocated once, reused forever */
-    static char* buffer1 = NULL;
-    static char* buffer2 = NULL;
-    
-    /* Per-stream state - need to track which stream we're reading */
-    static FILE* last_stream = NULL;
-    static char* current_buf = NULL;
-    static size_t buf_pos = 0;
-    static size_t buf_len = 0;
-    static int current_buffer = 0;
+    /* fgets() leaves the buffering to stdio, so no state is kept here */
+    size_t line_pos = 0;
+    for (;;) {
+        char* chunk = *lineptr + line_pos;
+        size_t avail = *n - line_pos > INT_MAX ? INT_MAX : *n - line_pos;
+        
+        /* strlen() would stop at a null byte inside the line. Pre-fill with
+         * '\n' instead: the last byte that is not '\n' is the terminator
+         * fgets() wrote, whatever the line holds. */
+        memset(chunk, '\n', avail);
+        if (!fgets(chunk, (int)avail, stream)) break;
+        size_t len = avail - 1;
+        while (chunk[len] == '\n') len--;
+        line_pos += len;
+        if (len > 0 && chunk[len - 1] == '\n') return (ssize_t)line_pos;
+        
+        if (line_pos + 1 >= *n) {
+            size_t new_size = *n * 2;
+            char* new_ptr = realloc(*lineptr, new_size);
+            if (!new_ptr) return -1;
+            *lineptr = new_ptr;
+            *n = new_size;
+        }
+    }
+    return line_pos > 0 ? (ssize_t)line_pos : -1;
+#endif
+}
+
+/* ============================================================================
+ * Buffered Line Reader
+ * ============================================================================ */
+
+typedef struct {
+    FILE* stream;        /* Source stream, or NULL when reading fd */
+    int fd;              /* Source descriptor, or -1 */
+    char* buffer;
+    size_t capacity;
+    size_t start;        /* First unconsumed byte */
+    size_t scanned;      /* Bytes from start known to hold no newline */
+    size_t end;          /* One past the last buffered byte */
+    int eof;
+    int error;
+} c_reader_t;
+
+static inline c_reader_t* c_reader_new(FILE* stream, int fd) {
+    c_reader_t* reader = calloc(1, sizeof(c_reader_t));
+    if (!reader) return NULL;
     
-    /* Allocate buffers on first use */
-    if (!buffer1) {
-        buffer1 = malloc(GETLINE_BUFFER_SIZE);
-        buffer2 = malloc(GETLINE_BUFFER_SIZE);
-        if (!buffer1 || !buffer2) return -1;
+    reader->buffer = malloc(C_READER_BUFFER_SIZE);
+    if (!reader->buffer) {
+        free(reader);
+        return NULL;
+    }
+    reader->capacity = C_READER_BUFFER_SIZE;
+    reader->stream = stream;
+    reader->fd = fd;
+    return reader;
+}
+
+/**
+ * c_reader_open - Create a line reader over a stream
+ * @stream: Stream to read from (not closed by c_reader_close)
+ *
+ * Returns: Reader, or NULL on failure
+ */
+static inline c_reader_t* c_reader_open(FILE* stream) {
+    if (!stream) return NULL;
+    return c_reader_new(stream, -1);
+}
+
+#if defined(_POSIX_C_SOURCE)
+/**
+ * c_reader_open_fd - Create a line reader over a file descriptor
+ * @fd: Descriptor to read from (not closed by c_reader_close)
+ *
+ * Returns: Reader, or NULL on failure
+ */
+static inline c_reader_t* c_reader_open_fd(int fd) {
+    if (fd < 0) return NULL;
+    return c_reader_new(NULL, fd);
+}
+#endif
+
+/* Move the unconsumed bytes to the front and read more after them */
+static inline int c_reader_fill(c_reader_t* reader) {
+    if (reader->start > 0) {
+        memmove(reader->buffer, reader->buffer + reader->start, reader->end - reader->start);
+        reader->end -= reader->start;
+        reader->start = 0;
     }
     
-    /* Stream changed? Reset state */
-    if (stream != last_stream) {
-        last_stream = stream;
-        buf_pos = 0;
-        buf_len = 0;
+    /* One byte is always kept free for the terminator of a last line */
+    if (reader->end + 1 >= reader->capacity) {
+        if (reader->capacity > SIZE_MAX / 2) {
+            reader->error = 1;
+            return 0;
+        }
+        char* new_buffer = realloc(reader->buffer, reader->capacity * 2);
+        if (!new_buffer) {
+            reader->error = 1;
+            return 0;
+        }
+        reader->buffer = new_buffer;
+        reader->capacity *= 2;
     }
     
-    size_t line_pos = 0;
+    size_t room = reader->capacity - reader->end - 1;
+    size_t got = 0;
+    if (reader->stream) {
+        got = fread(reader->buffer + reader->end, 1, room, reader->stream);
+        if (got == 0) {
+            if (ferror(reader->stream)) reader->error = 1;
+            reader->eof = 1;
+        }
+    }
+#if defined(_POSIX_C_SOURCE)
+    else {
+        ssize_t r;
+        do {
+            r = read(reader->fd, reader->buffer + reader->end, room);
+        } while (r < 0 && errno == EINTR);
+        if (r <= 0) {
+            if (r < 0) reader->error = 1;
+            reader->eof = 1;
+        } else {
+            got = (size_t)r;
+        }
+    }
+#endif
+    reader->end += got;
+    return got > 0;
+}
+
+/**
+ * c_reader_next_line - Return the next line without its newline
+ * @reader: Reader
+ * @len: Receives the line length (may be NULL)
+ *
+ * Returns: Null-terminated view into the reader's buffer, valid until the
+ *          next call, or NULL at end of input or on error
+ */
+static inline char* c_reader_next_line(c_reader_t* reader, size_t* len) {
+    if (!reader || reader->error) return NULL;
     
-    while (1) {
-        if (buf_pos >= buf_len) {
-            current_buffer = !current_buffer;
-            current_buf = current_buffer ? buffer2 : buffer1;
-            buf_len = fread(current_buf, 1, GETLINE_BUFFER_SIZE, stream);
-            buf_pos = 0;
-            
-            if (buf_len == 0) {
-                if (line_pos == 0) return -1;
-                (*lineptr)[line_pos] = '\0';
-                return line_pos;
-            }
+    for (;;) {
+        char* line = reader->buffer + reader->start;
+        char* newline = memchr(line + reader->scanned, '\n',
+                               reader->end - reader->start - reader->scanned);
+        if (newline) {
+            size_t line_len = (size_t)(newline - line);
+            reader->start += line_len + 1;
+            reader->scanned = 0;
+            if (line_len > 0 && line[line_len - 1] == '\r') line_len--;
+            line[line_len] = '\0';
+            if (len) *len = line_len;
+            return line;
         }
+        reader->scanned = reader->end - reader->start;
         
-        while (buf_pos < buf_len) {
-            char c = current_buf[buf_pos++];
+        if (reader->eof || !c_reader_fill(reader)) {
+            if (reader->error || reader->start == reader->end) return NULL;
             
-            if (line_pos + 1 >= *n) {
-                size_t new_size = *n * 2;
-                char* new_ptr = realloc(*lineptr, new_size);
-                if (!new_ptr) return -1;
-                *lineptr = new_ptr;
-                *n = new_size;
-            }
-            
-            (*lineptr)[line_pos++] = c;
-            
-            if (c == '\n') {
-                (*lineptr)[line_pos] = '\0';
-                return line_pos;
-            }
+            /* Last line without a newline; c_reader_fill() kept room for the null */
+            line = reader->buffer + reader->start;
+            size_t line_len = reader->end - reader->start;
+            reader->start = reader->end;
+            reader->scanned = 0;
+            if (line_len > 0 && line[line_len - 1] == '\r') line_len--;
+            line[line_len] = '\0';
+            if (len) *len = line_len;
+            return line;
         }
     }
-#endif
+}
+
+/**
+ * c_reader_error - Check whether a reader stopped on an error
+ * @reader: Reader
+ *
+ * Returns: Non-zero after a read or allocation error
+ */
+static inline int c_reader_error(const c_reader_t* reader) {
+    return !reader || reader->error;
+}
+
+/**
+ * c_reader_close - Free a reader (the stream or descriptor stays open)
+ * @reader: Reader or NULL
+ */
+static inline void c_reader_close(c_reader_t* reader) {
+    if (!reader) return;
+    free(reader->buffer);
+    free(reader);
 }
 
 /* ============================================================================
@@ -661,4 +839,4 @@ static inline size_t c_strlcat(char* dst, const char* src, size_t size) {
     return dst_len + src_len;
 }
 
-/* POSIX_COMPAT_H */
+#endif /* POSIX_COMPAT_H */
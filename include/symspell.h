@@ -22,10 +22,17 @@ extern "C" {
 #include <stdint.h>
 #include <stddef.h>
 #include <stdbool.h>
+#include <stdio.h>
 
 /* Maximum edit distance supported */
 #define SYMSPELL_MAX_EDIT_DISTANCE 3
 
+/* Most helper threads symspell_set_verify_threads() accepts */
+#define SYMSPELL_MAX_VERIFY_THREADS 64
+
+/* Longest delete string kept in an explain trace (including NUL) */
+#define SYMSPELL_EXPLAIN_MAX_DELETE 32
+
 /* Suggestion structure */
 typedef struct {
     char term[128];        /* Suggested word */
@@ -68,6 +75,67 @@ bool symspell_load_dictionary(
     int count_index
 );
 
+/* How symspell_load_index() brings an index image into memory */
+typedef enum {
+    SYMSPELL_INDEX_READ,       /* read() into a private heap copy */
+    SYMSPELL_INDEX_MMAP        /* mmap() the file; pages fault in on first use */
+} symspell_index_mode_t;
+
+/*
+ * Save a loaded dictionary as a binary index image
+ *
+ * The image holds the delete table slots and entries, posting lists,
+ * prefix groups, words, exact-match table and strings in the layout used
+ * at lookup time, so a dictionary from symspell_load_index() reads them in
+ * place. Integers are stored in native byte order. Saving a loaded
+ * dictionary first checks the parts of its image no lookup has checked
+ * yet, and fails on a corrupt one.
+ *
+ * Returns: true on success
+ */
+bool symspell_save_index(const symspell_dict_t* dict, const char* filepath);
+
+/*
+ * Save an index image laid out for a sample of traffic
+ *
+ * Each query is looked up at max_edit_distance, and the delete entries and
+ * posting lists it touched, and the prefix groups and words it verified,
+ * are written at the front of their sections; the rest follows. Pass a
+ * misspelling corpus or the terms of a recorded query trace.
+ * symspell_load_index() checks only that hot part, and with
+ * SYMSPELL_INDEX_MMAP starts reading it in; the cold part faults in on
+ * demand. Lookup results are the same as from symspell_save_index().
+ *
+ * Returns: true on success
+ */
+bool symspell_save_index_profiled(
+    const symspell_dict_t* dict,
+    const char* filepath,
+    const char* const* queries,
+    size_t query_count,
+    int max_edit_distance
+);
+
+/*
+ * Load a dictionary from an index image written by symspell_save_index()
+ *
+ * The returned dictionary is read-only (symspell_load_dictionary() fails on
+ * it) and owns the image; symspell_destroy() releases it.
+ *
+ * Loading checks the header, section bounds and alphabet, and the delete
+ * entries, prefix groups and words of a profiled image's hot part. The
+ * rest is checked as lookups reach it. Table slots, delete entries and
+ * posting group IDs are checked on every probe, and a prefix group and
+ * its words on first use. A corrupt slot or entry reads as empty and a
+ * corrupt group is skipped, silently. No lookup reads outside the image.
+ * The exact-match table, word frequencies, packed words and the word
+ * lengths against their strings are not checked. A corrupt image there
+ * gives wrong suggestions, so only load images from symspell_save_index().
+ *
+ * Returns: Dictionary handle or NULL on error
+ */
+symspell_dict_t* symspell_load_index(const char* filepath, symspell_index_mode_t mode);
+
 /*
  * Find spelling suggestions for a term
  * 
@@ -87,6 +155,141 @@ int symspell_lookup(
     int max_suggestions
 );
 
+/* One query-side delete examined by symspell_lookup_explain() */
+typedef struct {
+    char delete_str[SYMSPELL_EXPLAIN_MAX_DELETE];  /* Delete of the query prefix */
+    int depth;                 /* Characters deleted from the query prefix */
+    int probes;                /* Delete-table slots probed */
+    bool hit;                  /* Delete found in the table */
+    size_t posting_size;       /* Words in the posting list (0 on a miss) */
+} symspell_explain_delete_t;
+
+/* One dictionary word verified by symspell_lookup_explain() */
+typedef struct {
+    char term[128];
+    uint64_t frequency;
+    int distance;              /* Computed distance (> max when rejected) */
+    size_t delete_index;       /* Index in deletes[] that reached this word */
+    bool accepted;             /* Within distance */
+} symspell_explain_candidate_t;
+
+/*
+ * Structured trace of the work done by one lookup
+ *
+ * Filled by symspell_lookup_explain(), released by symspell_explain_free().
+ * Times are in nanoseconds; verify_ns is the part of search_ns spent in
+ * edit-distance verification.
+ */
+typedef struct {
+    char query[128];           /* Normalized (lowercased) query */
+    int max_edit_distance;     /* Effective distance after clamping */
+    bool exact_hit;            /* Answered by the exact-match table */
+    int exact_probes;          /* Exact-match slots probed */
+
+    symspell_explain_delete_t* deletes;
+    size_t delete_count;
+    symspell_explain_candidate_t* candidates;
+    size_t candidate_count;
+
+    size_t table_probes;       /* Delete-table slots probed in total */
+    size_t posting_hits;       /* Deletes that found a posting list */
+    size_t postings_visited;   /* Posting entries read (== verifications) */
+    size_t accepted;           /* Distinct candidates within distance */
+    bool truncated;            /* Trace incomplete (allocation failure) */
+
+    uint64_t normalize_ns;
+    uint64_t exact_ns;
+    uint64_t generate_ns;
+    uint64_t search_ns;
+    uint64_t verify_ns;
+    uint64_t rank_ns;
+    uint64_t total_ns;
+
+    long winner;               /* Index in candidates[] of the top result, -1 if none */
+    char reason[256];          /* Why the winner won */
+} symspell_explain_t;
+
+/*
+ * Find spelling suggestions and record how they were found
+ *
+ * Same results as symspell_lookup(); additionally fills explain. The normal
+ * symspell_lookup() path does not pay for the tracing.
+ *
+ * Returns: Number of suggestions found
+ */
+int symspell_lookup_explain(
+    const symspell_dict_t* dict,
+    const char* term,
+    int max_edit_distance,
+    symspell_suggestion_t* suggestions,
+    int max_suggestions,
+    symspell_explain_t* explain
+);
+
+/*
+ * Print an explain trace in human-readable form
+ */
+void symspell_explain_print(const symspell_explain_t* explain, FILE* out);
+
+/*
+ * Release the arrays owned by an explain trace
+ */
+void symspell_explain_free(symspell_explain_t* explain);
+
+/*
+ * Lookup hook, called after every symspell_lookup() or
+ * symspell_lookup_explain() that passed argument validation
+ *
+ * user_data: Pointer registered with symspell_set_lookup_hook()
+ * term: Input term exactly as passed to symspell_lookup()
+ * max_edit_distance / max_suggestions: Lookup parameters
+ * suggestions / count: Lookup result
+ * timestamp_ns: Wall-clock time the lookup started (CLOCK_REALTIME)
+ * latency_ns: Time spent inside the lookup, including lock wait (and, for
+ *             symspell_lookup_explain(), the cost of recording the trace)
+ *
+ * The hook runs outside the dictionary lock and may be called from several
+ * threads at once.
+ */
+typedef void (*symspell_lookup_hook_fn)(
+    void* user_data,
+    const char* term,
+    int max_edit_distance,
+    int max_suggestions,
+    const symspell_suggestion_t* suggestions,
+    int count,
+    uint64_t timestamp_ns,
+    uint64_t latency_ns
+);
+
+/*
+ * Install (or with hook == NULL, remove) the lookup hook
+ *
+ * Must not be called while lookups are in flight. With no hook installed
+ * the lookup path does not read the clock.
+ */
+void symspell_set_lookup_hook(
+    symspell_dict_t* dict,
+    symspell_lookup_hook_fn hook,
+    void* user_data
+);
+
+/*
+ * Verify the candidates of heavy lookups on helper threads
+ *
+ * threads: Helper threads besides the calling one, 0 (the default) to stop
+ *          them; at most SYMSPELL_MAX_VERIFY_THREADS
+ * min_words: Dictionary words a lookup must reach before its verification
+ *            is split; lighter lookups stay on the calling thread
+ *
+ * Results are identical to the sequential lookup. symspell_lookup_explain()
+ * never uses the helpers. Safe to call while lookups are in flight: the
+ * helpers are swapped between lookups.
+ *
+ * Returns: true on success (on failure no helpers are running)
+ */
+bool symspell_set_verify_threads(symspell_dict_t* dict, int threads, size_t min_words);
+
 /*
  * Free dictionary
  */
@@ -101,7 +304,56 @@ void symspell_get_stats(
     size_t* entry_count
 );
 
-/* 
+/* Probe histogram length; the last bucket collects all longer probes */
+#define SYMSPELL_PROBE_HISTOGRAM_SIZE 32
+
+/* Internal tables that can be inspected with symspell_get_table_stats() */
+typedef enum {
+    SYMSPELL_TABLE_DELETES,    /* delete -> words table (fuzzy path) */
+    SYMSPELL_TABLE_EXACT       /* 64-bit word hash table (fast path) */
+} symspell_table_t;
+
+/*
+ * Open-addressing diagnostics for one table
+ *
+ * Successful searches are counted once per stored key. Unsuccessful searches
+ * are counted once per slot, i.e. for a query hash that is uniform over the
+ * table. hit_probes[k] / miss_probes[k] count searches that took k+1 probes.
+ *
+ * The expected_*_misses fields estimate cache misses per lookup on a cold
+ * cache: distinct 64-byte lines of the slot array plus the out-of-line
+ * loads needed to compare each probed key.
+ */
+typedef struct {
+    size_t slots;                /* Table capacity */
+    size_t occupied;             /* Stored keys */
+    double load_factor;
+    size_t clusters;             /* Runs of consecutive occupied slots */
+    size_t longest_cluster;
+    double mean_cluster;
+    uint64_t hit_probes[SYMSPELL_PROBE_HISTOGRAM_SIZE];
+    uint64_t miss_probes[SYMSPELL_PROBE_HISTOGRAM_SIZE];
+    size_t max_hit_probes;
+    size_t max_miss_probes;
+    double mean_hit_probes;
+    double mean_miss_probes;
+    double expected_hit_misses;
+    double expected_miss_misses;
+} symspell_table_stats_t;
+
+/*
+ * Walk one of the dictionary's hash tables and report its probe-length and
+ * clustering statistics. Takes time proportional to the table size.
+ *
+ * Returns: true on success
+ */
+bool symspell_get_table_stats(
+    const symspell_dict_t* dict,
+    symspell_table_t table,
+    symspell_table_stats_t* stats
+);
+
+/*
  * Get word probability by hash (0.0 if not in dictionary)
  */
 float symspell_get_probability(
@@ -0,0 +1,191 @@
+/*
+ * symspell_probes.h - USDT (statically defined tracing) probe points
+ *
+ * Copyright (c) 2025 CGIOS Project
+ * SPDX-License-Identifier: MIT
+ *
+ * ============================================================================
+ * NAME
+ *     SYMSPELL_PROBE0 ... SYMSPELL_PROBE4 - user-space static tracepoints
+ *
+ * SYNOPSIS
+ *     #include "symspell_probes.h"
+ *
+ *     SYMSPELL_PROBE0(name);
+ *     SYMSPELL_PROBE2(name, arg1, arg2);
+ *     SYMSPELL_PROBE_SEMAPHORE(name);     (file scope, once per probe)
+ *
+ *     gcc -DSYMSPELL_USDT ...        (or: make USDT=1)
+ *
+ * DESCRIPTION
+ *     Each probe is a single nop instruction plus an ELF note in the
+ *     .note.stapsdt section recording its address, its semaphore and where
+ *     each argument lives. Tracers (bpftrace, SystemTap, bcc) find the
+ *     notes, increment the semaphore and patch a breakpoint over the nop
+ *     while attached, and read the arguments from registers or the stack.
+ *
+ *     The semaphore is a 16-bit counter in the .probes section, defined
+ *     once per probe with SYMSPELL_PROBE_SEMAPHORE(). The nop and the
+ *     argument expressions sit behind a test of it, so an unattached probe
+ *     costs one load and a not-taken branch and evaluates no arguments.
+ *     A tracer that ignores semaphores never sees the probe fire.
+ *
+ *     Probes belong to the provider "symspell". Arguments are converted to
+ *     64-bit integers; pass strings as pointers and read them with str().
+ *
+ *     Without SYMSPELL_USDT the macros expand to nothing and the argument
+ *     expressions are not evaluated. With it, <sys/sdt.h> is used when
+ *     present; otherwise an equivalent note is emitted directly on GCC or
+ *     Clang for x86-64 and AArch64, so the build needs no systemtap headers.
+ *
+ * PROBES
+ *     lookup__entry(term, term_len, max_edit_distance)
+ *     lookup__return(term_len, result_count, best_distance)
+ *         symspell_lookup() after argument validation, and after the lock is
+ *         released; best_distance is -1 when nothing was found.
+ *     lookup__exact(term_len, frequency)
+ *         Query answered by the exact-match table.
+ *     fuzzy__start(term_len, max_edit_distance, delete_count)
+ *     fuzzy__done(term_len, candidate_count, postings_visited)
+ *         Around the delete-table search of a non-exact query.
+ *     fuzzy__cached(term_len, max_edit_distance, group_count)
+ *         A non-exact query answered from the prefix cache instead: no
+ *         deletes are generated and fuzzy__start does not fire; fuzzy__done
+ *         still does.
+ *     delete__miss(delete_len, probes)
+ *         A query delete not present in the delete table, with the number
+ *         of slots probed to establish that.
+ *     load__start(filepath)
+ *     load__done(word_count, entry_count)
+ *         symspell_load_dictionary().
+ *     index__load__start(filepath, mmapped)
+ *     index__load__done(word_count, entry_count)
+ *         symspell_load_index().
+ *
+ * EXAMPLES
+ *     List the probes of a binary:
+ *         bpftrace -l 'usdt:./benchmark_symspell:symspell:*'
+ *
+ *     Lookup latency histogram of a running process:
+ *         bpftrace -p PID -e '
+ *           usdt:symspell:lookup__entry { @start[tid] = nsecs; }
+ *           usdt:symspell:lookup__return /@start[tid]/ {
+ *               @us = hist((nsecs - @start[tid]) / 1000); delete(@start[tid]); }'
+ *
+ *     Queries that fan out to the most postings:
+ *         bpftrace -p PID -e 'usdt:symspell:fuzzy__done { @[arg2] = count(); }'
+ */
+
+#ifndef SYMSPELL_PROBES_H
+#define SYMSPELL_PROBES_H
+
+#if defined(SYMSPELL_USDT) && defined(__has_include)
+#if __has_include(<sys/sdt.h>)
+#define SYMSPELL_HAVE_SYS_SDT 1
+/* Record symspell_<name>_semaphore in the notes instead of 0 */
+#define _SDT_HAS_SEMAPHORES 1
+#endif
+#endif
+
+#if !defined(SYMSPELL_USDT)
+
+#define SYMSPELL_PROBE0(name) do { } while (0)
+#define SYMSPELL_PROBE1(name, a1) do { } while (0)
+#define SYMSPELL_PROBE2(name, a1, a2) do { } while (0)
+#define SYMSPELL_PROBE3(name, a1, a2, a3) do { } while (0)
+#define SYMSPELL_PROBE4(name, a1, a2, a3, a4) do { } while (0)
+
+#elif defined(SYMSPELL_HAVE_SYS_SDT)
+
+#include <sys/sdt.h>
+
+#define SYMSPELL_SDT_PROBE0(name) DTRACE_PROBE(symspell, name)
+#define SYMSPELL_SDT_PROBE1(name, a1) DTRACE_PROBE1(symspell, name, a1)
+#define SYMSPELL_SDT_PROBE2(name, a1, a2) DTRACE_PROBE2(symspell, name, a1, a2)
+#define SYMSPELL_SDT_PROBE3(name, a1, a2, a3) DTRACE_PROBE3(symspell, name, a1, a2, a3)
+#define SYMSPELL_SDT_PROBE4(name, a1, a2, a3, a4) DTRACE_PROBE4(symspell, name, a1, a2, a3, a4)
+
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__aarch64__))
+
+#include <stdint.h>
+
+/*
+ * Same note layout as <sys/sdt.h> (version 3): probe address, address of
+ * the .stapsdt.base anchor (used to detect prelink relocation), semaphore
+ * address, provider, name, argument descriptors "8@<operand>" separated by
+ * spaces.
+ */
+#define SYMSPELL_SDT_NOTE(name, args)                                          \
+    "990: nop\n"                                                               \
+    ".pushsection .note.stapsdt,\"?\",\"note\"\n"                              \
+    ".balign 4\n"                                                              \
+    ".4byte 992f-991f, 994f-993f, 3\n"                                         \
+    "991: .asciz \"stapsdt\"\n"                                                \
+    "992: .balign 4\n"                                                         \
+    "993: .8byte 990b\n"                                                       \
+    ".8byte _.stapsdt.base\n"                                                  \
+    ".8byte symspell_" #name "_semaphore\n"                                   \
+    ".asciz \"symspell\"\n"                                                    \
+    ".asciz \"" #name "\"\n"                                                   \
+    ".asciz \"" args "\"\n"                                                    \
+    "994: .balign 4\n"                                                         \
+    ".popsection\n"                                                            \
+    ".ifndef _.stapsdt.base\n"                                                 \
+    ".pushsection .stapsdt.base,\"aG\",\"progbits\",.stapsdt.base,comdat\n"    \
+    ".weak _.stapsdt.base\n"                                                   \
+    ".hidden _.stapsdt.base\n"                                                 \
+    "_.stapsdt.base: .space 1\n"                                               \
+    ".size _.stapsdt.base, 1\n"                                                \
+    ".popsection\n"                                                            \
+    ".endif\n"
+
+#define SYMSPELL_SDT_ARG(a) "nor"((int64_t)(intptr_t)(a))
+
+#define SYMSPELL_SDT_PROBE0(name) \
+    __asm__ __volatile__(SYMSPELL_SDT_NOTE(name, ""))
+#define SYMSPELL_SDT_PROBE1(name, a1) \
+    __asm__ __volatile__(SYMSPELL_SDT_NOTE(name, "8@%0") \
+                         :: SYMSPELL_SDT_ARG(a1))
+#define SYMSPELL_SDT_PROBE2(name, a1, a2) \
+    __asm__ __volatile__(SYMSPELL_SDT_NOTE(name, "8@%0 8@%1") \
+                         :: SYMSPELL_SDT_ARG(a1), SYMSPELL_SDT_ARG(a2))
+#define SYMSPELL_SDT_PROBE3(name, a1, a2, a3) \
+    __asm__ __volatile__(SYMSPELL_SDT_NOTE(name, "8@%0 8@%1 8@%2") \
+                         :: SYMSPELL_SDT_ARG(a1), SYMSPELL_SDT_ARG(a2), \
+                            SYMSPELL_SDT_ARG(a3))
+#define SYMSPELL_SDT_PROBE4(name, a1, a2, a3, a4) \
+    __asm__ __volatile__(SYMSPELL_SDT_NOTE(name, "8@%0 8@%1 8@%2 8@%3") \
+                         :: SYMSPELL_SDT_ARG(a1), SYMSPELL_SDT_ARG(a2), \
+                            SYMSPELL_SDT_ARG(a3), SYMSPELL_SDT_ARG(a4))
+
+#else
+#error "SYMSPELL_USDT needs <sys/sdt.h> on this compiler/architecture"
+#endif
+
+#if defined(SYMSPELL_USDT)
+
+/* Tracers increment the semaphore while attached; it lives in .probes */
+#define SYMSPELL_PROBE_SEMAPHORE(name) \
+    __attribute__((section(".probes"), used)) \
+    volatile unsigned short symspell_##name##_semaphore
+
+#define SYMSPELL_PROBE_GATED(name, probe)                                      \
+    do {                                                                       \
+        extern volatile unsigned short symspell_##name##_semaphore;            \
+        if (__builtin_expect(symspell_##name##_semaphore != 0, 0)) { probe; }  \
+    } while (0)
+
+#define SYMSPELL_PROBE0(name) \
+    SYMSPELL_PROBE_GATED(name, SYMSPELL_SDT_PROBE0(name))
+#define SYMSPELL_PROBE1(name, a1) \
+    SYMSPELL_PROBE_GATED(name, SYMSPELL_SDT_PROBE1(name, a1))
+#define SYMSPELL_PROBE2(name, a1, a2) \
+    SYMSPELL_PROBE_GATED(name, SYMSPELL_SDT_PROBE2(name, a1, a2))
+#define SYMSPELL_PROBE3(name, a1, a2, a3) \
+    SYMSPELL_PROBE_GATED(name, SYMSPELL_SDT_PROBE3(name, a1, a2, a3))
+#define SYMSPELL_PROBE4(name, a1, a2, a3, a4) \
+    SYMSPELL_PROBE_GATED(name, SYMSPELL_SDT_PROBE4(name, a1, a2, a3, a4))
+
+#endif
+
+#endif /* SYMSPELL_PROBES_H */
@@ -0,0 +1,87 @@
+/*
+ * symspell_reference.h - Reference SymSpell engine for differential testing
+ *
+ * The lookup of the original src/symspell.c, kept as it was (see the top of
+ * src/symspell_reference.c for the few edits). It shares only xxh3.h and
+ * hash.h with the current engine, so an optimization of the real engine can
+ * be checked query by query against the behaviour it replaced
+ * (differential_symspell).
+ *
+ * The reference is only compiled with SYMSPELL_REFERENCE_ENGINE defined and
+ * is not part of the library. It is slow to load and serializes lookups.
+ *
+ * Semantics it pins down (and the real engine must keep):
+ *   - the query is truncated to 127 bytes and lowercased
+ *   - an exact dictionary word (matched by its 64-bit xxh3 hash) returns
+ *     itself at distance 0
+ *   - otherwise candidates are the words sharing a delete of their prefix
+ *     with a delete of the query prefix, verified by restricted
+ *     Damerau-Levenshtein (optimal string alignment) distance
+ *   - at most DELETE_QUEUE_CAPACITY deletes per term and
+ *     MAX_CANDIDATES_PER_LOOKUP candidates per lookup
+ *   - queries of 4 characters or fewer search at distance 1
+ *   - ranking: smallest distance, then highest frequency, then strcmp()
+ *   - without DO_SORT only the top suggestion is returned
+ *
+ * Copyright (c) 2025 CGIOS Project
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef SYMSPELL_REFERENCE_H
+#define SYMSPELL_REFERENCE_H
+
+#ifdef SYMSPELL_REFERENCE_ENGINE
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include "symspell.h"
+
+typedef struct symspell_reference symspell_reference_t;
+
+/*
+ * Create an empty reference dictionary (same parameters as symspell_create)
+ *
+ * Returns: Handle or NULL on error
+ */
+symspell_reference_t* symspell_reference_create(int max_edit_distance, int prefix_length);
+
+/*
+ * Load a dictionary file the way the original loader did: fgets() into a
+ * 512-byte buffer, so lines of 511 bytes or more are split, which
+ * symspell_load_dictionary() no longer does
+ *
+ * Returns: true on success
+ */
+bool symspell_reference_load_dictionary(
+    symspell_reference_t* ref,
+    const char* filepath,
+    int term_index,
+    int count_index
+);
+
+/*
+ * Lookup with the semantics of symspell_lookup(). Only term, distance and
+ * frequency of the suggestions are filled in.
+ *
+ * Returns: Number of suggestions found
+ */
+int symspell_reference_lookup(
+    const symspell_reference_t* ref,
+    const char* term,
+    int max_edit_distance,
+    symspell_suggestion_t* suggestions,
+    int max_suggestions
+);
+
+void symspell_reference_destroy(symspell_reference_t* ref);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SYMSPELL_REFERENCE_ENGINE */
+
+#endif /* SYMSPELL_REFERENCE_H */
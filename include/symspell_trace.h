@@ -0,0 +1,129 @@
+/*
+ * symspell_trace.h - Query trace capture and replay support
+ *
+ * A query trace is a compact binary log of symspell_lookup() calls: the
+ * term, the lookup parameters, when it happened, how long it took and what
+ * it returned. Traces are captured in production through the lookup hook
+ * and replayed against any dictionary build with replay_symspell.
+ *
+ * Capturing:
+ *
+ *     symspell_trace_writer_t* tw = symspell_trace_writer_open("lookups.sst");
+ *     symspell_set_lookup_hook(dict, symspell_trace_hook, tw);
+ *     ...
+ *     symspell_set_lookup_hook(dict, NULL, NULL);
+ *     symspell_trace_writer_close(tw);
+ *
+ * FILE FORMAT
+ *     8-byte magic "SSTRACE1", followed by one record per lookup. All
+ *     integers are unsigned LEB128 varints unless noted:
+ *
+ *         timestamp delta   zigzag varint, ns since the previous record
+ *                           (since 0 for the first record)
+ *         latency_ns
+ *         max_edit_distance
+ *         max_suggestions
+ *         term length, term bytes
+ *         result count      total suggestions returned
+ *         stored count      suggestions that follow (<= SYMSPELL_TRACE_MAX_RESULTS)
+ *         per suggestion:   term length, term bytes, distance, frequency
+ *
+ * Copyright (c) 2025 CGIOS Project
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef SYMSPELL_TRACE_H
+#define SYMSPELL_TRACE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "symspell.h"
+
+/* Suggestions stored per record; further results are only counted */
+#define SYMSPELL_TRACE_MAX_RESULTS 8
+
+/* One decoded trace record */
+typedef struct {
+    uint64_t timestamp_ns;     /* Wall-clock start of the lookup */
+    uint64_t latency_ns;       /* Recorded latency */
+    int max_edit_distance;     /* Lookup parameters */
+    int max_suggestions;
+    char term[128];            /* Query as passed to symspell_lookup() */
+    int result_count;          /* Suggestions returned by the lookup */
+    int stored_count;          /* Suggestions present in results[] */
+    symspell_suggestion_t results[SYMSPELL_TRACE_MAX_RESULTS];
+} symspell_trace_record_t;
+
+typedef struct symspell_trace_writer symspell_trace_writer_t;
+typedef struct symspell_trace_reader symspell_trace_reader_t;
+
+/*
+ * Create a trace file (truncates an existing one)
+ *
+ * Returns: Writer handle or NULL on error
+ */
+symspell_trace_writer_t* symspell_trace_writer_open(const char* filepath);
+
+/*
+ * Append one record. Safe to call from several threads.
+ *
+ * Returns: true on success
+ */
+bool symspell_trace_write(
+    symspell_trace_writer_t* writer,
+    const symspell_trace_record_t* record
+);
+
+/*
+ * Lookup hook that appends every lookup to the writer passed as user_data
+ */
+void symspell_trace_hook(
+    void* user_data,
+    const char* term,
+    int max_edit_distance,
+    int max_suggestions,
+    const symspell_suggestion_t* suggestions,
+    int count,
+    uint64_t timestamp_ns,
+    uint64_t latency_ns
+);
+
+/*
+ * Flush and close the trace file
+ *
+ * Returns: Number of records written
+ */
+uint64_t symspell_trace_writer_close(symspell_trace_writer_t* writer);
+
+/*
+ * Open a trace file for reading
+ *
+ * Returns: Reader handle or NULL if the file is missing or not a trace
+ */
+symspell_trace_reader_t* symspell_trace_reader_open(const char* filepath);
+
+/*
+ * Decode the next record
+ *
+ * Returns: true if a record was read, false at end of file or on a
+ *          truncated/corrupt record
+ */
+bool symspell_trace_read(
+    symspell_trace_reader_t* reader,
+    symspell_trace_record_t* record
+);
+
+/*
+ * Close a trace reader
+ */
+void symspell_trace_reader_close(symspell_trace_reader_t* reader);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SYMSPELL_TRACE_H */
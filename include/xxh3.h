@@ -18,14 +18,26 @@ Copyright (C) 2012-2020 Yann Collet
 #include <stddef.h>
 #include <stdint.h>
 #include <inttypes.h>
+#include <string.h>
 
 #define XXH3_STRIPE_LEN           64
 #define XXH3_SECRET_CONSUME_RATE  8
 #define XXH3_ACC_NB               8
 #define XXH3_SECRET_DEFAULT_SIZE  192
 #define XXH3_SECRET_SIZE_MIN      136
-#define xxh3(x, len) xxh3_XXH3_64bits_const(x, len)
-#define XXH3_64bits(x, len) xxh3_XXH3_64bits_const(x, len)
+#define xxh3(x, len) xxh3_64bits(x, len)
+#define XXH3_64bits(x, len) xxh3_64bits(x, len)
+
+/* Native unaligned loads are the little-endian encoding on these targets */
+#ifndef XXH3_NATIVE_LE
+#if (defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__) || \
+    defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86) || \
+    defined(_M_ARM64)
+#define XXH3_NATIVE_LE 1
+#else
+#define XXH3_NATIVE_LE 0
+#endif
+#endif
 
 /* Structure to replace std::pair<uint64_t, uint64_t> */
 typedef struct {
@@ -305,6 +317,237 @@ static inline uint64_t xxh3_XXH3_64bits_withSeed_const(const void* input, size_t
       xxh3_hashLong_with_seed);
 }
 
+/*
+ * Runtime path for keys of up to 16 bytes (words and prefix deletes).
+ * Same algorithm and results as xxh3_XXH3_64bits_const() with the default
+ * secret and seed 0, but the secret words are folded into constants and
+ * the input is read with single unaligned loads instead of byte by byte.
+ * Longer keys take the portable path. xxh3() and XXH3_64bits() use this.
+ */
+
+static inline uint32_t xxh3_read32(const void* ptr) {
+#if XXH3_NATIVE_LE
+  uint32_t v;
+  memcpy(&v, ptr, sizeof(v));
+  return v;
+#else
+  return xxh3_readLE32(ptr);
+#endif
+}
+
+static inline uint64_t xxh3_read64(const void* ptr) {
+#if XXH3_NATIVE_LE
+  uint64_t v;
+  memcpy(&v, ptr, sizeof(v));
+  return v;
+#else
+  return xxh3_readLE64(ptr);
+#endif
+}
+
+static inline uint64_t xxh3_bswap64(uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+  return __builtin_bswap64(x);
+#else
+  return xxh3_swap64(x);
+#endif
+}
+
+static inline uint64_t xxh3_64bits_short(const uint8_t* inp, size_t len) {
+  if (len < 4) {
+    if (len == 0) {
+      return xxh3_XXH64_avalanche(xxh3_readLE64(xxh3_kSecret + 56) ^
+                                  xxh3_readLE64(xxh3_kSecret + 64));
+    }
+    uint64_t keyed = (((uint32_t)inp[0] << 16) | ((uint32_t)inp[len >> 1] << 24) |
+                      inp[len - 1] | ((uint32_t)len << 8)) ^
+        (uint64_t)(xxh3_readLE32(xxh3_kSecret) ^ xxh3_readLE32(xxh3_kSecret + 4));
+    return xxh3_XXH64_avalanche(keyed);
+  }
+  if (len <= 8) {
+    uint64_t keyed = (xxh3_read32(inp + len - 4) + ((uint64_t)xxh3_read32(inp) << 32)) ^
+        (xxh3_readLE64(xxh3_kSecret + 8) ^ xxh3_readLE64(xxh3_kSecret + 16));
+    return xxh3_rrmxmx(keyed, len);
+  }
+  uint64_t input_lo = xxh3_read64(inp) ^
+      (xxh3_readLE64(xxh3_kSecret + 24) ^ xxh3_readLE64(xxh3_kSecret + 32));
+  uint64_t input_hi = xxh3_read64(inp + len - 8) ^
+      (xxh3_readLE64(xxh3_kSecret + 40) ^ xxh3_readLE64(xxh3_kSecret + 48));
+  uint64_t acc = len + xxh3_bswap64(input_lo) + input_hi +
+                 xxh3_mul128_fold64(input_lo, input_hi);
+  return xxh3_XXH3_avalanche(acc);
+}
+
+static inline uint64_t xxh3_64bits(const void* input, size_t len) {
+  if (len <= 16) return xxh3_64bits_short((const uint8_t*)input, len);
+  return xxh3_XXH3_64bits_const(input, len);
+}
+
+/*
+ * Batched hashing
+ *
+ * xxh3_64bits_batch() hashes count independent keys: out[i] is
+ * xxh3(keys[i].ptr, keys[i].len). Keys are taken in blocks of
+ * XXH3_BATCH_BLOCK and grouped by length class; on x86-64 CPUs with AVX2
+ * (checked at runtime) the 4-8 and 9-16 byte classes are mixed four
+ * keys per instruction, everything else goes through xxh3_64bits(). The
+ * 64-bit multiplies are built from 32-bit ones, as AVX2 has no 64x64
+ * multiply. Define XXH3_NO_SIMD to force the scalar path.
+ *
+ * It only beats a loop over xxh3() on long runs of mixed lengths; on
+ * short runs of one length class the scalar loop is faster (benchmark_hash
+ * times both).
+ */
+
+typedef struct {
+  const void* ptr;
+  size_t len;
+} xxh3_key_t;
+
+#define XXH3_BATCH_BLOCK 64
+
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__) && !defined(XXH3_NO_SIMD)
+#define XXH3_BATCH_AVX2 1
+#include <immintrin.h>
+
+#define XXH3_TARGET_AVX2 __attribute__((target("avx2")))
+
+/* Low 64 bits of a * b in each lane */
+XXH3_TARGET_AVX2 static inline __m256i xxh3_avx2_mullo64(__m256i a, __m256i b) {
+  __m256i cross = _mm256_add_epi64(_mm256_mul_epu32(_mm256_srli_epi64(a, 32), b),
+                                   _mm256_mul_epu32(a, _mm256_srli_epi64(b, 32)));
+  return _mm256_add_epi64(_mm256_mul_epu32(a, b), _mm256_slli_epi64(cross, 32));
+}
+
+/* xxh3_mul128_fold64() in each lane, via xxh3_mult64to128()'s partial products */
+XXH3_TARGET_AVX2 static inline __m256i xxh3_avx2_mul128_fold64(__m256i a, __m256i b) {
+  const __m256i low32 = _mm256_set1_epi64x(0xFFFFFFFFLL);
+  __m256i a_hi = _mm256_srli_epi64(a, 32);
+  __m256i b_hi = _mm256_srli_epi64(b, 32);
+  __m256i lo_lo = _mm256_mul_epu32(a, b);
+  __m256i hi_lo = _mm256_mul_epu32(a_hi, b);
+  __m256i lo_hi = _mm256_mul_epu32(a, b_hi);
+  __m256i hi_hi = _mm256_mul_epu32(a_hi, b_hi);
+  __m256i cross = _mm256_add_epi64(_mm256_add_epi64(_mm256_srli_epi64(lo_lo, 32),
+                                                    _mm256_and_si256(hi_lo, low32)), lo_hi);
+  __m256i upper = _mm256_add_epi64(_mm256_add_epi64(_mm256_srli_epi64(hi_lo, 32),
+                                                    _mm256_srli_epi64(cross, 32)), hi_hi);
+  __m256i lower = _mm256_or_si256(_mm256_slli_epi64(cross, 32), _mm256_and_si256(lo_lo, low32));
+  return _mm256_xor_si256(upper, lower);
+}
+
+/* Four keys of 4-8 bytes: xxh3_rrmxmx() of the keyed input */
+XXH3_TARGET_AVX2 static inline __m256i xxh3_avx2_4to8(const xxh3_key_t* k0, const xxh3_key_t* k1,
+                                                      const xxh3_key_t* k2, const xxh3_key_t* k3) {
+#define XXH3_KEYED_4TO8(k) \
+  (long long)(xxh3_read32((const uint8_t*)(k)->ptr + (k)->len - 4) + \
+              ((uint64_t)xxh3_read32((k)->ptr) << 32))
+  __m256i h = _mm256_set_epi64x(XXH3_KEYED_4TO8(k3), XXH3_KEYED_4TO8(k2),
+                                XXH3_KEYED_4TO8(k1), XXH3_KEYED_4TO8(k0));
+#undef XXH3_KEYED_4TO8
+  __m256i len = _mm256_set_epi64x((long long)k3->len, (long long)k2->len,
+                                  (long long)k1->len, (long long)k0->len);
+  const __m256i prime = _mm256_set1_epi64x((long long)0x9FB21C651E98DF25ULL);
+  h = _mm256_xor_si256(h, _mm256_set1_epi64x((long long)(xxh3_readLE64(xxh3_kSecret + 8) ^
+                                                         xxh3_readLE64(xxh3_kSecret + 16))));
+  h = _mm256_xor_si256(h, _mm256_xor_si256(
+      _mm256_or_si256(_mm256_slli_epi64(h, 49), _mm256_srli_epi64(h, 15)),
+      _mm256_or_si256(_mm256_slli_epi64(h, 24), _mm256_srli_epi64(h, 40))));
+  h = xxh3_avx2_mullo64(h, prime);
+  h = _mm256_xor_si256(h, _mm256_add_epi64(_mm256_srli_epi64(h, 35), len));
+  h = xxh3_avx2_mullo64(h, prime);
+  return _mm256_xor_si256(h, _mm256_srli_epi64(h, 28));
+}
+
+/* Four keys of 9-16 bytes */
+XXH3_TARGET_AVX2 static inline __m256i xxh3_avx2_9to16(const xxh3_key_t* k0, const xxh3_key_t* k1,
+                                                       const xxh3_key_t* k2, const xxh3_key_t* k3) {
+#define XXH3_FIRST8(k) (long long)xxh3_read64((k)->ptr)
+#define XXH3_LAST8(k) (long long)xxh3_read64((const uint8_t*)(k)->ptr + (k)->len - 8)
+  __m256i input_lo = _mm256_set_epi64x(XXH3_FIRST8(k3), XXH3_FIRST8(k2),
+                                       XXH3_FIRST8(k1), XXH3_FIRST8(k0));
+  __m256i input_hi = _mm256_set_epi64x(XXH3_LAST8(k3), XXH3_LAST8(k2),
+                                       XXH3_LAST8(k1), XXH3_LAST8(k0));
+#undef XXH3_FIRST8
+#undef XXH3_LAST8
+  __m256i len = _mm256_set_epi64x((long long)k3->len, (long long)k2->len,
+                                  (long long)k1->len, (long long)k0->len);
+  const __m256i bswap = _mm256_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8,
+                                         7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+  input_lo = _mm256_xor_si256(input_lo, _mm256_set1_epi64x(
+      (long long)(xxh3_readLE64(xxh3_kSecret + 24) ^ xxh3_readLE64(xxh3_kSecret + 32))));
+  input_hi = _mm256_xor_si256(input_hi, _mm256_set1_epi64x(
+      (long long)(xxh3_readLE64(xxh3_kSecret + 40) ^ xxh3_readLE64(xxh3_kSecret + 48))));
+  __m256i acc = _mm256_add_epi64(len, _mm256_shuffle_epi8(input_lo, bswap));
+  acc = _mm256_add_epi64(acc, input_hi);
+  acc = _mm256_add_epi64(acc, xxh3_avx2_mul128_fold64(input_lo, input_hi));
+  acc = _mm256_xor_si256(acc, _mm256_srli_epi64(acc, 37));
+  acc = xxh3_avx2_mullo64(acc, _mm256_set1_epi64x((long long)0x165667919E3779F9ULL));
+  return _mm256_xor_si256(acc, _mm256_srli_epi64(acc, 32));
+}
+
+/* Hash the grouped keys of one class, four at a time */
+XXH3_TARGET_AVX2 static inline size_t xxh3_avx2_group(const xxh3_key_t* keys, const uint8_t* group,
+                                                      size_t count, int long_class, uint64_t* out) {
+  size_t j = 0;
+  for (; j + 4 <= count; j += 4) {
+    const xxh3_key_t* k0 = &keys[group[j]];
+    const xxh3_key_t* k1 = &keys[group[j + 1]];
+    const xxh3_key_t* k2 = &keys[group[j + 2]];
+    const xxh3_key_t* k3 = &keys[group[j + 3]];
+    __m256i h = long_class ? xxh3_avx2_9to16(k0, k1, k2, k3) : xxh3_avx2_4to8(k0, k1, k2, k3);
+    uint64_t result[4];
+    _mm256_storeu_si256((__m256i*)result, h);
+    out[group[j]] = result[0];
+    out[group[j + 1]] = result[1];
+    out[group[j + 2]] = result[2];
+    out[group[j + 3]] = result[3];
+  }
+  return j;
+}
+
+/* libgcc fills the CPU model in a constructor, so this is a read-only check */
+static inline int xxh3_batch_simd_available(void) {
+  return __builtin_cpu_supports("avx2") ? 1 : 0;
+}
+
+#else
+
+static inline int xxh3_batch_simd_available(void) {
+  return 0;
+}
+
+#endif
+
+static inline void xxh3_64bits_batch(const xxh3_key_t* keys, size_t count, uint64_t* out) {
+  int simd = xxh3_batch_simd_available();
+  for (size_t base = 0; base < count; base += XXH3_BATCH_BLOCK) {
+    size_t n = (count - base < XXH3_BATCH_BLOCK) ? count - base : XXH3_BATCH_BLOCK;
+    /* Class 0: 4-8 bytes, class 1: 9-16 bytes */
+    uint8_t grouped[2][XXH3_BATCH_BLOCK];
+    size_t grouped_count[2] = {0, 0};
+    for (size_t i = 0; i < n; i++) {
+      size_t len = keys[base + i].len;
+      if (simd && len >= 4 && len <= 16) {
+        int c = len > 8;
+        grouped[c][grouped_count[c]++] = (uint8_t)i;
+      } else {
+        out[base + i] = xxh3_64bits(keys[base + i].ptr, len);
+      }
+    }
+    for (int c = 0; c < 2; c++) {
+      size_t j = 0;
+#ifdef XXH3_BATCH_AVX2
+      if (simd) j = xxh3_avx2_group(keys + base, grouped[c], grouped_count[c], c, out + base);
+#endif
+      for (; j < grouped_count[c]; j++) {
+        const xxh3_key_t* k = &keys[base + grouped[c][j]];
+        out[base + grouped[c][j]] = xxh3_64bits(k->ptr, k->len);
+      }
+    }
+  }
+}
+
 /* Convenient interfaces for arrays */
 
 static inline uint64_t xxh3_XXH3_64bits_const_array(const void* input, size_t array_size) {
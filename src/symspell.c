@@ -16,23 +16,36 @@
  * - symspell_dict_t* symspell_create(...)
  * - void symspell_destroy(...)
  * - bool symspell_load_dictionary(...)
+ * - bool symspell_save_index(...)
+ * - symspell_dict_t* symspell_load_index(...)
  * - int symspell_lookup(...)
+ * - int symspell_lookup_explain(...)
+ * - void symspell_set_lookup_hook(...)
  * - void symspell_get_stats(...)
+ * - bool symspell_get_table_stats(...)
  *
  * Copyright (c) 2025 CGIOS Project
  * SPDX-License-Identifier: MIT
  */
 
+#define _POSIX_C_SOURCE 200809L
+
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
 #include <ctype.h>
 #include <math.h>
 #include <errno.h>
+#include <time.h>
 #include <pthread.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include "posix.h"
 #include "xxh3.h"
 #include "symspell.h"
+#include "symspell_probes.h"
 #include "hash.h"
 
 /*
@@ -42,18 +55,69 @@
  * The DO_SORT define sorts the candidates by edit_distance, frequency, then alphabetical
  * This makes candidate[0] the top ranking candidate.
  * While this is the default behaviour of SymSpell implementations, unless selected with the
- * DO_SORT define we make a single pass through the candidates and return the single best choice.
+ * DO_SORT define we make a single pass through the candidates and return the single best choice,
+ * using the same order (so both builds agree on the top suggestion).
  * Note the once built the sysmspell.o will retain this behaviour.
  */
 
+#ifdef SYMSPELL_USDT
+/* One semaphore per probe; see symspell_probes.h for the probe list */
+SYMSPELL_PROBE_SEMAPHORE(lookup__entry);
+SYMSPELL_PROBE_SEMAPHORE(lookup__return);
+SYMSPELL_PROBE_SEMAPHORE(lookup__exact);
+SYMSPELL_PROBE_SEMAPHORE(fuzzy__start);
+SYMSPELL_PROBE_SEMAPHORE(fuzzy__done);
+SYMSPELL_PROBE_SEMAPHORE(fuzzy__cached);
+SYMSPELL_PROBE_SEMAPHORE(delete__miss);
+SYMSPELL_PROBE_SEMAPHORE(load__start);
+SYMSPELL_PROBE_SEMAPHORE(load__done);
+SYMSPELL_PROBE_SEMAPHORE(index__load__start);
+SYMSPELL_PROBE_SEMAPHORE(index__load__done);
+#endif
+
 /* --- Constants --- */
 #define SYMSPELL_MAX_TERM_LENGTH 128
 #define INITIAL_ENTRY_CAPACITY 4
+#define ENTRY_INLINE_POSTINGS 2
+#define DELETE_INLINE_KEY 15
+
+/* Packed words: 5-bit symbol codes, 12 to a 64-bit word (see pack_word) */
+#define ALPHABET_MAX 31
+#define PACKED_SYMBOL_BITS 5
+#define PACKED_SYMBOLS_PER_WORD 12
+#define PACKED_WORD_MAX 24
+#define WORD_PENDING UINT32_MAX
+/* A posting is a prefix-group ID with its dictionary-side depth on top */
+#define POSTING_DEPTH_SHIFT 30
+#define POSTING_GROUP_MASK ((1u << POSTING_DEPTH_SHIFT) - 1)
 #define DELETE_QUEUE_CAPACITY 10000
-#define MAX_LINE_BUFFER 512
 #define MAX_PARTS_PER_LINE 10
 #define MAX_CANDIDATES_PER_LOOKUP 10000
 #define HASH_TABLE_LOAD_WARNING_THRESHOLD 0.75
+#define EXPLAIN_GROWTH 64
+
+/* Candidate-set cache of the fuzzy path (see prefix_cache_key) */
+#define PREFIX_CACHE_SLOTS 1024
+#define PREFIX_CACHE_MAX_GROUPS 256
+
+/* Groups ahead of the one being verified whose words are prefetched */
+#define VERIFY_PREFETCH_DISTANCE 4
+
+/* Hottest frequency tier of the word layout; later tiers double (see add_loaded_words) */
+#define LAYOUT_TIER_GROUPS 1024
+
+/* Binary index image (see symspell_save_index) */
+#define INDEX_MAGIC "SSINDEX1"
+#define INDEX_MAGIC_SIZE 8
+#define INDEX_VERSION 6
+#define INDEX_BYTE_ORDER 0x01020304u
+#define INDEX_ALIGN 8
+#define INDEX_SLOT_EMPTY 0
+
+/* States of an image's prefix group in dict->group_checked */
+#define GROUP_UNCHECKED 0
+#define GROUP_VALID 1
+#define GROUP_CORRUPT 2
 
 #define STRING_ARENA_SIZE (128 * 1024 * 1024) // 128MB arena for strings
 #define ENTRY_ARENA_SIZE (128 * 1024 * 1024)  // 128MB arena for entry structs
@@ -72,6 +136,26 @@
 /* Exact match table size - ~500k slots for up to 250k words at 50% load */
 #define EXACT_MATCH_TABLE_SIZE 524287
 
+/* Cold-cache model used by symspell_get_table_stats() */
+#define CACHE_LINE_SIZE 64
+#define DELETE_COMPARE_LOADS 1   /* table[idx] -> entry, keys are inline */
+#define EXACT_COMPARE_LOADS 0    /* hashes are compared in place */
+#define SLOT_EMPTY UINT32_MAX
+
+/* Force inlining so constant arguments specialize the lookup core */
+#if defined(__GNUC__) || defined(__clang__)
+#define SYMSPELL_ALWAYS_INLINE inline __attribute__((always_inline))
+#else
+#define SYMSPELL_ALWAYS_INLINE inline
+#endif
+
+/* Start loading a cache line the lookup will need a few steps later */
+#if defined(__GNUC__) || defined(__clang__)
+#define SYMSPELL_PREFETCH(addr) __builtin_prefetch(addr)
+#else
+#define SYMSPELL_PREFETCH(addr) ((void)(addr))
+#endif
+
 /* A simple memory arena for fast allocation */
 typedef struct {
     char* memory;
@@ -79,24 +163,139 @@ typedef struct {
     size_t used;
 } arena_t;
 
-/* Hash table entry for delete -> words mapping */
+/*
+ * A delete as stored in the delete table. Deletes come from a prefix of at
+ * most prefix_length bytes, so with the default configuration every key
+ * fits in two NUL-padded words and compares with two integer compares.
+ */
+typedef union {
+    uint64_t words[2];          /* Up to DELETE_INLINE_KEY bytes, NUL-padded */
+    const char* str;            /* Longer deletes, in dict->strings */
+} delete_key_t;
+
+/*
+ * Hash table entry for delete -> prefix groups mapping. Most deletes are
+ * reached by one or two groups; those postings live in the entry itself
+ * and only longer lists spill to an array (read them via entry_postings).
+ * A spilled array grows by doubling from INITIAL_ENTRY_CAPACITY, so its
+ * capacity follows from count.
+ */
 typedef struct delete_entry {
-    const char* delete_str;     /* Points into the string_arena */
-    const char** words;         /* Points into the string_arena */
-    uint64_t* frequencies;      /* Frequency of each word */
-    size_t count;               /* Number of words */
-    size_t capacity;            /* Allocated capacity */
+    delete_key_t key;
+    uint32_t key_length;
+    uint32_t count;             /* Postings: prefix-group ID | depth << 30 */
+    union {
+        uint32_t inline_groups[ENTRY_INLINE_POSTINGS];
+        uint32_t* groups;
+    } postings;
 } delete_entry_t;
 
+/* An interned dictionary word; its index in dict->word_table is its ID */
+typedef struct {
+    uint32_t offset;        /* Offset of the word in dict->strings */
+    uint32_t length;
+    uint64_t frequency;
+    uint64_t packed[2];     /* Symbol codes, first in the low bits; {0, 0} if unpacked */
+} word_entry_t;
+
+/*
+ * Words sharing their first prefix_length characters, and so every delete:
+ * word IDs first .. first + count - 1
+ */
+typedef struct {
+    uint32_t first;
+    uint32_t count;
+} prefix_group_t;
+
+/*
+ * A cached fuzzy search: the prefix groups reached by the deletes of one
+ * (query prefix, distance) pair, in the order the search expanded them
+ */
+typedef struct {
+    uint64_t key;           /* prefix_cache_key(), 0 = empty */
+    uint32_t count;         /* Groups in the slot's prefix_cache_groups row */
+} prefix_cache_slot_t;
+
+/* A prefix group reached by a fuzzy lookup, queued for verification */
+typedef struct {
+    uint32_t group;
+    int32_t short_distance;     /* See verify_group(); -1 when unknown */
+} found_group_t;
+
 /* Fast exact-match lookup table using 64-bit hashes */
 typedef struct {
     uint64_t* hashes;       /* 64-bit word hashes */
     uint64_t* frequencies;  /* Word frequencies */
     float* probabilities;   /* Probabilities */
     float* iwf;             /* Inverse Word Frequency */
+    uint32_t* word_ids;     /* Word ID of each word (NULL for an index image) */
     size_t table_size;
 } exact_match_table_t;
 
+/* A dictionary word read by the loader, waiting for its prefix group */
+typedef struct {
+    uint64_t prefix_hash;   /* xxh3 of the word's first prefix_length bytes */
+    uint64_t frequency;     /* Final frequency, set once the file is read */
+    uint32_t word;          /* Offset of the interned word in dict->strings */
+    uint32_t length;
+    uint32_t order;         /* Line order, breaks frequency ties */
+    uint32_t exact_pos;     /* Slot of the word in the exact table */
+} load_word_t;
+
+/* A prefix group of loaded words: words[start .. start + count - 1] */
+typedef struct {
+    const char* word;       /* Its most frequent word */
+    uint64_t frequency;     /* ... that word's frequency */
+    uint32_t order;         /* ... and line order */
+    uint32_t start;
+    uint32_t count;
+} load_group_t;
+
+/*
+ * Index image header. Every section starts at an INDEX_ALIGN-aligned offset
+ * from the start of the file; integers are in native byte order, checked
+ * through byte_order.
+ */
+typedef struct {
+    char magic[INDEX_MAGIC_SIZE];
+    uint32_t version;
+    uint32_t byte_order;
+    uint32_t max_edit_distance;
+    uint32_t prefix_length;
+    uint64_t word_count;
+    uint64_t entry_count;
+    uint64_t table_size;
+    uint64_t exact_table_size;
+    uint64_t posting_count;
+    uint64_t group_count;
+    uint64_t word_table_count;
+    uint64_t strings_size;
+    uint64_t file_size;
+    uint64_t slots_off;          /* uint32_t[table_size]: entry number + 1, 0 = empty */
+    uint64_t entries_off;        /* index_entry_t[entry_count] */
+    uint64_t posting_groups_off; /* uint32_t[posting_count]: depth-tagged group IDs */
+    uint64_t groups_off;         /* prefix_group_t[group_count] */
+    uint64_t word_table_off;     /* word_entry_t[word_table_count] */
+    uint64_t exact_hashes_off;   /* uint64_t[exact_table_size] */
+    uint64_t exact_freqs_off;    /* uint64_t[exact_table_size] */
+    uint64_t exact_probs_off;    /* float[exact_table_size] */
+    uint64_t exact_iwf_off;      /* float[exact_table_size] */
+    uint64_t strings_off;        /* char[strings_size], NUL-terminated strings */
+    uint64_t hot_entry_count;    /* Leading entries, postings, groups and words */
+    uint64_t hot_posting_count;  /* a traffic profile touched (see */
+    uint64_t hot_group_count;    /* symspell_save_index_profiled); 0 without */
+    uint64_t hot_word_count;
+    uint8_t symbols[256];        /* Alphabet of the packed words */
+} index_header_t;
+
+/* One delete entry in an index image; its postings are contiguous */
+typedef struct {
+    uint64_t key[2];             /* Inline key, or key[0] = offset in strings */
+    uint32_t key_length;
+    uint32_t count;              /* Groups in the posting list */
+    uint64_t first;              /* Index of the first posting */
+} index_entry_t;
+
 /* SymSpell dictionary structure with pre-allocated work buffers */
 struct symspell_dict {
     delete_entry_t** table;           /* Hash table for deletes */
@@ -109,12 +308,74 @@ struct symspell_dict {
 
     pthread_mutex_t lookup_mutex;     /* Mutex for thread safety */
 
+    /* Optional observer of every lookup (see symspell_set_lookup_hook) */
+    symspell_lookup_hook_fn lookup_hook;
+    void* lookup_hook_data;
+
+    /* Helper threads for heavy lookups (see symspell_set_verify_threads) */
+    struct verify_pool* verify_pool;
+
     /* Arenas for fast, contiguous allocation during load */
     arena_t string_arena;
     arena_t entry_arena;
+
+    /* Base of all interned strings: string_arena.memory, or the strings
+     * section of a loaded index image */
+    const char* strings;
+    size_t strings_size;
+
+    /* Interned words by ID, and the prefix groups postings refer to */
+    word_entry_t* word_table;
+    size_t word_table_count;
+    size_t word_table_capacity;
+    prefix_group_t* groups;
+    size_t group_count;
+    size_t group_capacity;
+
+    /* Alphabet of the packed words: symbols[b] is the code of byte b, 0
+     * for bytes outside it. Codes are only ever added, so words packed by
+     * an earlier load stay valid */
+    uint8_t symbols[256];
+    int symbol_count;
+
+    /* group_seen[g] == lookup_stamp once the current lookup has expanded
+     * group g; both are only touched under lookup_mutex */
+    uint32_t* group_seen;
+    uint32_t lookup_stamp;
+
+    /* Groups the current lookup reached, in the order it reached them */
+    found_group_t* found_groups;
+    size_t found_capacity;
+
+    /* Direct-mapped prefix cache; slot i owns prefix_cache_groups[i *
+     * PREFIX_CACHE_MAX_GROUPS ...]. Only touched under lookup_mutex and
+     * emptied by every load */
+    prefix_cache_slot_t* prefix_cache;
+    uint32_t* prefix_cache_groups;
+
+    /* Index image backing a dictionary from symspell_load_index(); the
+     * exact table, groups, words and strings point into it, and the delete
+     * table is read in place from its slots, entries and postings (table
+     * is then NULL) */
+    void* index_image;
+    size_t index_image_size;
+    bool index_mapped;                /* image is mmap()ed, else malloc()ed */
+    const uint32_t* index_slots;      /* Entry number + 1 per slot, 0 = empty */
+    const index_entry_t* index_entries;
+    const uint32_t* index_postings;
+    size_t index_posting_count;
+
+    /* group_checked[g] is GROUP_UNCHECKED until a lookup first reaches
+     * group g of an image (see group_usable); NULL for a built dictionary,
+     * whose groups are trusted. Only touched under lookup_mutex */
+    uint8_t* group_checked;
     
     /* Reusable work buffers for lookup path */
     char** delete_work_buffer;
+    size_t* delete_lengths;           /* Length of each delete */
+    uint64_t* delete_hashes;          /* xxh3 of each delete */
+    delete_key_t* delete_packed;      /* Each delete in table-key form */
+    size_t* delete_slots;             /* Home slot of each delete */
     size_t delete_buffer_capacity;
     symspell_suggestion_t* candidate_buffer;    
 };
@@ -229,6 +490,66 @@ static int edit_distance(const char* s1, const char* s2, int max_distance) {
     return d[len1][len2];
 }
 
+/* A lookup query prepared for bit-parallel verification of packed words */
+typedef struct {
+    uint64_t peq[ALPHABET_MAX + 1];    /* Bit i set where query[i] has the code */
+    uint64_t last;                     /* Bit of the last query character */
+    int length;                        /* 0 when the query cannot be used */
+} query_pattern_t;
+
+/*
+ * Build the match masks of a query of 1 to 64 bytes. Bytes outside the
+ * alphabet match no dictionary symbol and simply set no bit.
+ */
+static void query_pattern_init(query_pattern_t* pattern, const symspell_dict_t* dict,
+                               const char* query, int query_len) {
+    memset(pattern->peq, 0, sizeof(pattern->peq));
+    pattern->length = 0;
+    if (query_len < 1 || query_len > 64 || dict->symbol_count == 0) return;
+    for (int i = 0; i < query_len; i++) {
+        pattern->peq[dict->symbols[(unsigned char)query[i]]] |= 1ULL << i;
+    }
+    pattern->peq[0] = 0;
+    pattern->last = 1ULL << (query_len - 1);
+    pattern->length = query_len;
+}
+
+/*
+ * edit_distance() of the query and a packed word, one column of the DP
+ * matrix per word symbol in a handful of 64-bit operations (Hyyro's
+ * bit-vector algorithm with the transposition extension). The vertical
+ * deltas of the column live in vp/vn; score tracks its last cell.
+ */
+static int packed_distance(const query_pattern_t* pattern, const word_entry_t* word,
+                           int max_distance) {
+    uint64_t vp = ~0ULL;
+    uint64_t vn = 0;
+    uint64_t d0 = 0;
+    uint64_t pm_prev = 0;
+    int score = pattern->length;
+    int n = (int)word->length;
+
+    for (int j = 0; j < n; j++) {
+        unsigned code = (unsigned)(word->packed[j / PACKED_SYMBOLS_PER_WORD] >>
+                                   (PACKED_SYMBOL_BITS * (j % PACKED_SYMBOLS_PER_WORD))) & ALPHABET_MAX;
+        uint64_t pm = pattern->peq[code];
+        uint64_t tr = (((~d0) & pm) << 1) & pm_prev;
+        d0 = (((pm & vp) + vp) ^ vp) | pm | vn | tr;
+        uint64_t hp = vn | ~(d0 | vp);
+        uint64_t hn = d0 & vp;
+        if (hp & pattern->last) score++;
+        else if (hn & pattern->last) score--;
+        /* The last cell drops by at most one per remaining column */
+        if (score - (n - 1 - j) > max_distance) return max_distance + 1;
+        hp = (hp << 1) | 1;
+        hn <<= 1;
+        vp = hn | ~(d0 | hp);
+        vn = hp & d0;
+        pm_prev = pm;
+    }
+    return score <= max_distance ? score : max_distance + 1;
+}
+
 /*
  * Internal shared function to generate all unique deletes for a term
  * Uses caller-provided buffer to avoid malloc/free in hot paths
@@ -256,7 +577,17 @@ static size_t _generate_all_deletes_reuse(
         int distance;
     } queue_item_t;
 
-    queue_item_t* queue = malloc(DELETE_QUEUE_CAPACITY * sizeof(queue_item_t));
+    /* At most sum(C(prefix_len, k), k = 0..max_distance) distinct strings
+     * (the prefix and its deletes); size the scratch space to that instead
+     * of the full queue capacity, which costs an mmap() per call */
+    size_t distinct = 1, combinations = 1;
+    for (int k = 1; k <= max_distance && k <= prefix_len; k++) {
+        combinations = combinations * (size_t)(prefix_len - k + 1) / (size_t)k;
+        distinct += combinations;
+    }
+    int queue_capacity = distinct < DELETE_QUEUE_CAPACITY ? (int)distinct : DELETE_QUEUE_CAPACITY;
+
+    queue_item_t* queue = malloc(queue_capacity * sizeof(queue_item_t));
     if (!queue) {
         fprintf(stderr, "Error: Failed to allocate delete queue\n");
         return 0;
@@ -265,7 +596,7 @@ static size_t _generate_all_deletes_reuse(
     size_t delete_count = 0;
 
     /* Create portable hash table for uniqueness checking */
-    HT_TABLE* uniq_set = ht_create(max_deletes * 2);
+    HT_TABLE* uniq_set = ht_create((distinct < max_deletes ? distinct : max_deletes) * 2);
     if (!uniq_set) {
         fprintf(stderr, "Error: Failed to create uniqueness hash table\n");
         free(queue);
@@ -349,7 +680,7 @@ static size_t _generate_all_deletes_reuse(
             }
 
             /* Add to queue for next level processing */
-            if (queue_end < DELETE_QUEUE_CAPACITY) {
+            if (queue_end < queue_capacity) {
                 bool in_queue = false;
                 for (int q = queue_start; q < queue_end; q++) {
                     if (strcmp(queue[q].str, deleted) == 0) {
@@ -371,46 +702,83 @@ static size_t _generate_all_deletes_reuse(
     return delete_count;
 }
 
-/* Add word to delete entry */
-static bool add_to_entry(symspell_dict_t* dict, delete_entry_t* entry, const char* word, uint64_t freq) {
-    for (size_t i = 0; i < entry->count; i++) {
-        if (strcmp(entry->words[i], word) == 0) {
-            if (freq > entry->frequencies[i]) entry->frequencies[i] = freq;
-            return true;
-        }
+/* Postings of a delete entry, inline or spilled */
+static inline const uint32_t* entry_postings(const delete_entry_t* entry) {
+    return entry->count > ENTRY_INLINE_POSTINGS ? entry->postings.groups
+                                                : entry->postings.inline_groups;
+}
+
+/* A delete entry's key as a NUL-terminated string */
+static inline const char* entry_key(const delete_entry_t* entry) {
+    return entry->key_length <= DELETE_INLINE_KEY ? (const char*)entry->key.words
+                                                  : entry->key.str;
+}
+
+/* Pack a delete into table-key form; a long key just points at str */
+static inline void pack_delete_key(delete_key_t* key, const char* str, size_t len) {
+    if (len <= DELETE_INLINE_KEY) {
+        key->words[0] = 0;
+        key->words[1] = 0;
+        memcpy(key->words, str, len);
+    } else {
+        key->str = str;
     }
-    
-    if (entry->count >= entry->capacity) {
-        size_t new_cap = entry->capacity == 0 ? INITIAL_ENTRY_CAPACITY : entry->capacity * 2;
-        const char** new_words = realloc(entry->words, new_cap * sizeof(const char*));
-        if (!new_words) return false;
-        entry->words = new_words;
-        
-        uint64_t* new_freqs = realloc(entry->frequencies, new_cap * sizeof(uint64_t));
-        if (!new_freqs) return false;
-        entry->frequencies = new_freqs;
-        entry->capacity = new_cap;
+}
+
+static inline bool entry_key_equals(const delete_entry_t* entry, const delete_key_t* key,
+                                    size_t len) {
+    if (entry->key_length != len) return false;
+    if (len <= DELETE_INLINE_KEY) {
+        return entry->key.words[0] == key->words[0] && entry->key.words[1] == key->words[1];
     }
-    
-    entry->words[entry->count] = arena_strdup(&dict->string_arena, word);
-    if (!entry->words[entry->count]) return false;
-    
-    entry->frequencies[entry->count] = freq;
-    entry->count++;
+    return memcmp(entry->key.str, key->str, len) == 0;
+}
+
+/*
+ * Append a prefix group to a delete entry (each group reaches it once).
+ * depth is the number of characters deleted from the group's prefix.
+ */
+static bool add_group_to_entry(delete_entry_t* entry, uint32_t group_id, uint32_t depth) {
+    uint32_t posting = group_id | (depth << POSTING_DEPTH_SHIFT);
+    uint32_t count = entry->count;
+    if (count < ENTRY_INLINE_POSTINGS) {
+        entry->postings.inline_groups[entry->count++] = posting;
+        return true;
+    }
+    if (count == ENTRY_INLINE_POSTINGS) {
+        uint32_t* spilled = malloc(INITIAL_ENTRY_CAPACITY * sizeof(uint32_t));
+        if (!spilled) return false;
+        memcpy(spilled, entry->postings.inline_groups, sizeof(entry->postings.inline_groups));
+        entry->postings.groups = spilled;
+    } else if (count >= INITIAL_ENTRY_CAPACITY && (count & (count - 1)) == 0) {
+        /* Full: capacity is the power of two count just reached */
+        uint32_t* new_groups = realloc(entry->postings.groups, 2 * (size_t)count * sizeof(uint32_t));
+        if (!new_groups) return false;
+        entry->postings.groups = new_groups;
+    }
+    entry->postings.groups[entry->count++] = posting;
     return true;
 }
 
-/* Add word to exact match table during dictionary load */
-static bool add_exact_match(symspell_dict_t* dict, const char* word, uint64_t freq) {
-    uint64_t word_hash = xxh3(word, strlen(word));
+/*
+ * Add word to exact match table during dictionary load. *pos receives its
+ * slot; a new word's ID is WORD_PENDING until its prefix group is indexed.
+ * Returns false when the table is full.
+ */
+static bool add_exact_match(symspell_dict_t* dict, const char* word, size_t len,
+                            uint64_t freq, size_t* pos_out, bool* added) {
+    uint64_t word_hash = xxh3(word, len);
     size_t idx = word_hash % dict->exact_table->table_size;
     
     for (size_t probe = 0; probe < dict->exact_table->table_size; probe++) {
         size_t pos = (idx + probe) % dict->exact_table->table_size;
+        *pos_out = pos;
         
         if (dict->exact_table->hashes[pos] == 0) {
             dict->exact_table->hashes[pos] = word_hash;
             dict->exact_table->frequencies[pos] = freq;
+            dict->exact_table->word_ids[pos] = WORD_PENDING;
+            *added = true;
             return true;
         }
         
@@ -418,6 +786,7 @@ static bool add_exact_match(symspell_dict_t* dict, const char* word, uint64_t fr
             if (freq > dict->exact_table->frequencies[pos]) {
                 dict->exact_table->frequencies[pos] = freq;
             }
+            *added = false;
             return true;
         }
     }
@@ -425,56 +794,280 @@ static bool add_exact_match(symspell_dict_t* dict, const char* word, uint64_t fr
     return false;
 }
 
-/* Add delete variant to hash table */
-static bool add_delete(symspell_dict_t* dict, const char* delete_str,
-                       const char* word, uint64_t freq) {
+/*
+ * Hash and pack the first count deletes of the work buffer. Deletes are
+ * short (prefix_length bytes or fewer) and few per term, where scalar xxh3()
+ * beats xxh3_64bits_batch(): the batch only pays off on long mixed runs.
+ */
+static void hash_deletes(const symspell_dict_t* dict, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        const char* key = dict->delete_work_buffer[i];
+        size_t len = strlen(key);
+        dict->delete_lengths[i] = len;
+        dict->delete_hashes[i] = xxh3(key, len);
+        pack_delete_key(&dict->delete_packed[i], key, len);
+    }
+}
 
-    uint64_t hash = xxh3(delete_str, strlen(delete_str));
+/* Find the entry of work-buffer delete d (hashed and packed), adding it if new */
+static delete_entry_t* find_or_add_delete(symspell_dict_t* dict, size_t d) {
+    const delete_key_t* key = &dict->delete_packed[d];
+    size_t len = dict->delete_lengths[d];
+    uint64_t hash = dict->delete_hashes[d];
 
     for (size_t i = 0; i < dict->table_size; i++) {
         size_t idx = (hash + i) % dict->table_size;
 
         if (dict->table[idx] == NULL) {
             delete_entry_t* entry = arena_calloc(&dict->entry_arena, 1, sizeof(delete_entry_t));
-            if (!entry) return false;
-
-            entry->delete_str = arena_strdup(&dict->string_arena, delete_str);
-            if (!entry->delete_str) return false;
+            if (!entry) return NULL;
 
-            if (!add_to_entry(dict, entry, word, freq)) {
-                return false;
+            entry->key_length = (uint32_t)len;
+            if (len <= DELETE_INLINE_KEY) {
+                entry->key = *key;
+            } else {
+                entry->key.str = arena_strdup(&dict->string_arena, key->str);
+                if (!entry->key.str) return NULL;
             }
+
             dict->table[idx] = entry;
             dict->entry_count++;
-            return true;
+            return entry;
         }
 
-        if (strcmp(dict->table[idx]->delete_str, delete_str) == 0) {
-            return add_to_entry(dict, dict->table[idx], word, freq);
+        if (entry_key_equals(dict->table[idx], key, len)) {
+            return dict->table[idx];
         }
     }
-    return false;
+    return NULL;
+}
+
+/* Make room for one more element; returns the (moved) array or NULL */
+static void* grow_array(void* array, size_t* capacity, size_t count, size_t size) {
+    if (count < *capacity) return array;
+    size_t new_cap = *capacity ? *capacity * 2 : 1024;
+    void* grown = c_reallocarray(array, new_cap, size);
+    if (grown) *capacity = new_cap;
+    return grown;
+}
+
+/* Length of the part of a word that deletes are generated from */
+static size_t word_prefix_len(const symspell_dict_t* dict, size_t len) {
+    return len > (size_t)dict->prefix_length ? (size_t)dict->prefix_length : len;
+}
+
+/*
+ * Extend the alphabet with the bytes of newly loaded words, most frequent
+ * first, until it holds ALPHABET_MAX symbols. English needs 26; a larger
+ * character set leaves words with the rarest bytes unpacked.
+ */
+static void extend_alphabet(symspell_dict_t* dict, const load_word_t* words, size_t count) {
+    size_t seen[256] = { 0 };
+    for (size_t i = 0; i < count; i++) {
+        const unsigned char* word = (const unsigned char*)dict->strings + words[i].word;
+        for (uint32_t j = 0; j < words[i].length; j++) seen[word[j]]++;
+    }
+    while (dict->symbol_count < ALPHABET_MAX) {
+        int best = -1;
+        for (int b = 0; b < 256; b++) {
+            if (seen[b] && !dict->symbols[b] && (best < 0 || seen[b] > seen[best])) best = b;
+        }
+        if (best < 0) break;
+        dict->symbols[best] = (uint8_t)++dict->symbol_count;
+    }
+}
+
+/* Pack a word as symbol codes; words that do not fit stay {0, 0} */
+static void pack_word(const symspell_dict_t* dict, const char* word, size_t len,
+                      uint64_t packed[2]) {
+    uint64_t out[2] = { 0, 0 };
+    packed[0] = packed[1] = 0;
+    if (len > PACKED_WORD_MAX) return;
+    for (size_t i = 0; i < len; i++) {
+        uint64_t code = dict->symbols[(unsigned char)word[i]];
+        if (!code) return;
+        out[i / PACKED_SYMBOLS_PER_WORD] |=
+            code << (PACKED_SYMBOL_BITS * (i % PACKED_SYMBOLS_PER_WORD));
+    }
+    packed[0] = out[0];
+    packed[1] = out[1];
 }
 
-/* Generate all deletes for a word and add to dictionary */
-static bool generate_deletes(symspell_dict_t* dict, const char* word, uint64_t freq) {
+/*
+ * Add a group of words sharing one prefix: give the words consecutive IDs,
+ * then generate, hash and locate the prefix's deletes once and append the
+ * group ID to each entry.
+ */
+static bool add_prefix_group(symspell_dict_t* dict, const load_word_t* group, size_t count) {
+    prefix_group_t* groups = grow_array(dict->groups, &dict->group_capacity,
+                                        dict->group_count, sizeof(prefix_group_t));
+    if (!groups || dict->group_count >= POSTING_GROUP_MASK) return false;
+    dict->groups = groups;
+    uint32_t group_id = (uint32_t)dict->group_count;
+    prefix_group_t* g = &dict->groups[dict->group_count++];
+    g->first = (uint32_t)dict->word_table_count;
+    g->count = (uint32_t)count;
+
+    for (size_t w = 0; w < count; w++) {
+        word_entry_t* table = grow_array(dict->word_table, &dict->word_table_capacity,
+                                         dict->word_table_count, sizeof(word_entry_t));
+        if (!table || dict->word_table_count >= WORD_PENDING) return false;
+        dict->word_table = table;
+        uint32_t id = (uint32_t)dict->word_table_count++;
+        word_entry_t* word = &dict->word_table[id];
+        word->offset = group[w].word;
+        word->length = group[w].length;
+        word->frequency = dict->exact_table->frequencies[group[w].exact_pos];
+        pack_word(dict, dict->strings + word->offset, word->length, word->packed);
+        dict->exact_table->word_ids[group[w].exact_pos] = id;
+    }
+
     size_t delete_count = _generate_all_deletes_reuse(
-        word, dict->max_edit_distance, dict->prefix_length,
+        dict->strings + group[0].word, dict->max_edit_distance, dict->prefix_length,
         dict->delete_work_buffer, dict->delete_buffer_capacity
     );
 
+    hash_deletes(dict, delete_count);
+
+    size_t prefix_len = word_prefix_len(dict, group[0].length);
+    bool ok = true;
     for (size_t i = 0; i < delete_count; i++) {
-        add_delete(dict, dict->delete_work_buffer[i], word, freq);
+        if (ok) {
+            delete_entry_t* entry = find_or_add_delete(dict, i);
+            uint32_t depth = (uint32_t)(prefix_len - dict->delete_lengths[i]);
+            ok = entry && add_group_to_entry(entry, group_id, depth);
+        }
         free(dict->delete_work_buffer[i]);
         dict->delete_work_buffer[i] = NULL;
     }
+    return ok;
+}
+
+/* Sort loaded words into prefix groups, most frequent first within a group */
+static int load_word_compare(const void* a, const void* b) {
+    const load_word_t* wa = a;
+    const load_word_t* wb = b;
+    if (wa->prefix_hash != wb->prefix_hash) return wa->prefix_hash < wb->prefix_hash ? -1 : 1;
+    if (wa->frequency != wb->frequency) return wa->frequency > wb->frequency ? -1 : 1;
+    return (wa->order > wb->order) - (wa->order < wb->order);
+}
+
+/* Order prefix groups by their most frequent word, then by line order */
+static int load_group_compare(const void* a, const void* b) {
+    const load_group_t* ga = a;
+    const load_group_t* gb = b;
+    if (ga->frequency != gb->frequency) return ga->frequency > gb->frequency ? -1 : 1;
+    return (ga->order > gb->order) - (ga->order < gb->order);
+}
+
+/* Order prefix groups alphabetically */
+static int load_group_prefix_compare(const void* a, const void* b) {
+    return strcmp(((const load_group_t*)a)->word, ((const load_group_t*)b)->word);
+}
+
+/*
+ * Index all loaded words, one prefix group at a time, in layout order.
+ * Groups are ranked by their most frequent word and cut into tiers: the
+ * LAYOUT_TIER_GROUPS hottest, then tiers doubling in size. Tiers are added
+ * hottest first, so word IDs, the word table and the delete entries the
+ * groups create (in the entry arena, and nearest their home slots) start
+ * with the most frequent words. Within a tier groups go alphabetically: the
+ * groups one misspelling reaches mostly share its first letters, so they
+ * land on fewer pages than in pure frequency order.
+ */
+static bool add_loaded_words(symspell_dict_t* dict, load_word_t* words, size_t count) {
+    if (count == 0) return true;
+    extend_alphabet(dict, words, count);
+    for (size_t i = 0; i < count; i++) {
+        words[i].frequency = dict->exact_table->frequencies[words[i].exact_pos];
+    }
+    qsort(words, count, sizeof(load_word_t), load_word_compare);
+
+    load_group_t* groups = malloc(count * sizeof(load_group_t));
+    if (!groups) {
+        perror("symspell_load_dictionary failed: malloc groups");
+        return false;
+    }
+    size_t group_count = 0;
+    for (size_t start = 0; start < count; ) {
+        const char* first = dict->strings + words[start].word;
+        size_t prefix_len = word_prefix_len(dict, words[start].length);
+        size_t end = start + 1;
+        /* A prefix hash collision only splits a group, never merges two */
+        while (end < count && words[end].prefix_hash == words[start].prefix_hash &&
+               word_prefix_len(dict, words[end].length) == prefix_len &&
+               memcmp(dict->strings + words[end].word, first, prefix_len) == 0) {
+            end++;
+        }
+        load_group_t* g = &groups[group_count++];
+        g->word = first;
+        g->frequency = words[start].frequency;
+        g->order = words[start].order;
+        g->start = (uint32_t)start;
+        g->count = (uint32_t)(end - start);
+        start = end;
+    }
+    qsort(groups, group_count, sizeof(load_group_t), load_group_compare);
+    for (size_t tier = 0, size = LAYOUT_TIER_GROUPS; tier < group_count; tier += size, size *= 2) {
+        size_t n = group_count - tier < size ? group_count - tier : size;
+        qsort(groups + tier, n, sizeof(load_group_t), load_group_prefix_compare);
+    }
+
+    size_t next_report = 1000;
+    size_t added = 0;
+    for (size_t i = 0; i < group_count; i++) {
+        if (!add_prefix_group(dict, words + groups[i].start, groups[i].count)) {
+            free(groups);
+            return false;
+        }
+        added += groups[i].count;
+
+        if (added >= next_report) {
+            next_report = added - added % 1000 + 1000;
+            double load_factor = (double)dict->entry_count / dict->table_size;
+            fprintf(stderr, "\rLoaded %zu words, %zu deletes (%.1f%% full)...", 
+                    added, dict->entry_count, load_factor * 100);
+            fflush(stderr);
+            
+            if (load_factor > HASH_TABLE_LOAD_WARNING_THRESHOLD) {
+                fprintf(stderr, "\nWARNING: Hash table %.1f%% full\n", load_factor * 100);
+            }
+        }
+    }
+    free(groups);
     return true;
 }
 
-/* 
- * symspell_create function.
+/*
+ * Rewrite the strings one load interned, string_arena[start, end), in word
+ * ID order and without alignment padding, so the most frequent words share
+ * the first pages. Words first_id .. word_table_count - 1 are the ones the
+ * load added, and their strings are all in that range. Only the layout
+ * changes: on allocation failure the strings stay in line order.
  */
-symspell_dict_t* symspell_create(int max_edit_distance, int prefix_length) {
+static void order_loaded_strings(symspell_dict_t* dict, size_t first_id, size_t start, size_t end) {
+    if (end <= start) return;
+    char* laid_out = malloc(end - start);
+    if (!laid_out) return;
+    size_t used = 0;
+    for (size_t id = first_id; id < dict->word_table_count; id++) {
+        word_entry_t* word = &dict->word_table[id];
+        memcpy(laid_out + used, dict->strings + word->offset, word->length + 1);
+        word->offset = (uint32_t)(start + used);
+        used += word->length + 1;
+    }
+    memcpy(dict->string_arena.memory + start, laid_out, used);
+    memset(dict->string_arena.memory + start + used, 0, end - start - used);
+    free(laid_out);
+}
+
+/*
+ * Allocate a dictionary with its delete table, lookup work buffers and an
+ * empty exact-table descriptor. The exact-table arrays and the arenas are
+ * added by symspell_create(), or pointed into an image by
+ * symspell_load_index().
+ */
+static symspell_dict_t* dict_new(int max_edit_distance, int prefix_length) {
     if (max_edit_distance < 1 || max_edit_distance > SYMSPELL_MAX_EDIT_DISTANCE) {
         fprintf(stderr, "Error: max_edit_distance must be between 1 and %d\n", SYMSPELL_MAX_EDIT_DISTANCE);
         return NULL;
@@ -519,6 +1112,49 @@ symspell_dict_t* symspell_create(int max_edit_distance, int prefix_length) {
     
     dict->exact_table->table_size = EXACT_MATCH_TABLE_SIZE;
 
+    dict->delete_buffer_capacity = DELETE_QUEUE_CAPACITY;
+    dict->delete_work_buffer = calloc(dict->delete_buffer_capacity, sizeof(char*));
+    if (!dict->delete_work_buffer) {
+        perror("symspell_create failed: calloc dict->delete_work_buffer");
+        symspell_destroy(dict);
+        return NULL;
+    }
+    dict->delete_lengths = malloc(dict->delete_buffer_capacity * sizeof(size_t));
+    dict->delete_hashes = malloc(dict->delete_buffer_capacity * sizeof(uint64_t));
+    dict->delete_packed = malloc(dict->delete_buffer_capacity * sizeof(delete_key_t));
+    dict->delete_slots = malloc(dict->delete_buffer_capacity * sizeof(size_t));
+    if (!dict->delete_lengths || !dict->delete_hashes || !dict->delete_packed || !dict->delete_slots) {
+        perror("symspell_create failed: malloc dict->delete_hashes");
+        symspell_destroy(dict);
+        return NULL;
+    }
+    
+    dict->candidate_buffer = malloc(MAX_CANDIDATES_PER_LOOKUP * sizeof(symspell_suggestion_t));
+    if (!dict->candidate_buffer) {
+        perror("symspell_create failed: malloc dict->candidate_buffer");
+        symspell_destroy(dict);
+        return NULL;
+    }
+
+    dict->prefix_cache = calloc(PREFIX_CACHE_SLOTS, sizeof(prefix_cache_slot_t));
+    dict->prefix_cache_groups = malloc((size_t)PREFIX_CACHE_SLOTS * PREFIX_CACHE_MAX_GROUPS *
+                                       sizeof(uint32_t));
+    if (!dict->prefix_cache || !dict->prefix_cache_groups) {
+        perror("symspell_create failed: malloc dict->prefix_cache");
+        symspell_destroy(dict);
+        return NULL;
+    }
+
+    return dict;
+}
+
+/* 
+ * symspell_create function.
+ */
+symspell_dict_t* symspell_create(int max_edit_distance, int prefix_length) {
+    symspell_dict_t* dict = dict_new(max_edit_distance, prefix_length);
+    if (!dict) return NULL;
+
     dict->exact_table->hashes = calloc(dict->exact_table->table_size, sizeof(uint64_t));
     if (!dict->exact_table->hashes) {
         perror("symspell_create failed: calloc dict->exact_table->hashes");
@@ -546,18 +1182,10 @@ symspell_dict_t* symspell_create(int max_edit_distance, int prefix_length) {
         symspell_destroy(dict);
         return NULL;
     }
-    
-    dict->delete_buffer_capacity = DELETE_QUEUE_CAPACITY;
-    dict->delete_work_buffer = calloc(dict->delete_buffer_capacity, sizeof(char*));
-    if (!dict->delete_work_buffer) {
-        perror("symspell_create failed: calloc dict->delete_work_buffer");
-        symspell_destroy(dict);
-        return NULL;
-    }
-    
-    dict->candidate_buffer = malloc(MAX_CANDIDATES_PER_LOOKUP * sizeof(symspell_suggestion_t));
-    if (!dict->candidate_buffer) {
-        perror("symspell_create failed: malloc dict->candidate_buffer");
+
+    dict->exact_table->word_ids = calloc(dict->exact_table->table_size, sizeof(uint32_t));
+    if (!dict->exact_table->word_ids) {
+        perror("symspell_create failed: calloc dict->exact_table->word_ids");
         symspell_destroy(dict);
         return NULL;
     }
@@ -577,6 +1205,7 @@ symspell_dict_t* symspell_create(int max_edit_distance, int prefix_length) {
         symspell_destroy(dict);
         return NULL;
     }
+    dict->strings = dict->string_arena.memory;
     
     return dict;
 }
@@ -588,6 +1217,11 @@ bool symspell_load_dictionary(
     printf("Entering load dictionary with filepath %s\n", filepath);
 
     if (!dict || !filepath) return false;
+    if (dict->index_image) {
+        fprintf(stderr, "Error: dictionary loaded from an index is read-only\n");
+        return false;
+    }
+    SYMSPELL_PROBE1(load__start, filepath);
     
     FILE* fp = fopen(filepath, "r");
     if (!fp) {
@@ -595,23 +1229,35 @@ bool symspell_load_dictionary(
         return false;
     }
     
-    char line[MAX_LINE_BUFFER];
-    size_t line_num = 0;
+    c_reader_t* reader = c_reader_open(fp);
+    if (!reader) {
+        perror("symspell_load_dictionary failed: c_reader_open");
+        fclose(fp);
+        return false;
+    }
+    
+    char* line;
+    size_t line_len;
     uint64_t total_words = 0;
     uint64_t max_freq = 0;
+    load_word_t* words = NULL;
+    size_t word_count = 0, word_capacity = 0;
+    bool ok = true;
+    bool table_full = false;
+    size_t first_id = dict->word_table_count;
+    size_t strings_start = dict->string_arena.used;
     
-    while (fgets(line, sizeof(line), fp)) {
-        line_num++;
-        line[strcspn(line, "\r\n")] = '\0';
-        if (strlen(line) == 0) continue;
+    while ((line = c_reader_next_line(reader, &line_len))) {
+        if (line_len == 0) continue;
         
         char* parts[MAX_PARTS_PER_LINE];
         int part_count = 0;
-        char* token = strtok(line, " \t");
+        char* save = NULL;
+        char* token = strtok_r(line, " \t", &save);
         
         while (token && part_count < MAX_PARTS_PER_LINE) {
             parts[part_count++] = token;
-            token = strtok(NULL, " \t");
+            token = strtok_r(NULL, " \t", &save);
         }
         
         if (part_count <= term_index || part_count <= count_index) continue;
@@ -626,21 +1272,75 @@ bool symspell_load_dictionary(
         }
         
         str_tolower(term);
+        size_t term_len = strlen(term);
         
-        add_exact_match(dict, term, freq);
-        generate_deletes(dict, term, freq);
+        size_t pos;
+        bool added;
+        if (!add_exact_match(dict, term, term_len, freq, &pos, &added)) {
+            if (!table_full) fprintf(stderr, "\nWARNING: exact table full, skipping new words\n");
+            table_full = true;
+            continue;
+        }
         dict->word_count++;
-        
-        if (line_num % 1000 == 0) {
-            double load_factor = (double)dict->entry_count / dict->table_size;
-            fprintf(stderr, "\rLoaded %zu words, %zu deletes (%.1f%% full)...", 
-                    line_num, dict->entry_count, load_factor * 100);
-            fflush(stderr);
-            
-            if (load_factor > HASH_TABLE_LOAD_WARNING_THRESHOLD) {
-                fprintf(stderr, "\nWARNING: Hash table %.1f%% full\n", load_factor * 100);
+
+        /* A repeated word keeps its ID; the exact table has the larger frequency */
+        if (!added) {
+            uint32_t id = dict->exact_table->word_ids[pos];
+            if (id != WORD_PENDING) {
+                dict->word_table[id].frequency = dict->exact_table->frequencies[pos];
             }
+            continue;
+        }
+
+        /* Deletes are added per prefix group once the whole file is read */
+        load_word_t* grown = grow_array(words, &word_capacity, word_count, sizeof(load_word_t));
+        if (!grown) {
+            perror("symspell_load_dictionary failed: realloc words");
+            ok = false;
+            break;
+        }
+        words = grown;
+        const char* stored = arena_strdup(&dict->string_arena, term);
+        if (!stored) {
+            ok = false;
+            break;
         }
+        words[word_count].prefix_hash = xxh3(term, word_prefix_len(dict, term_len));
+        words[word_count].word = (uint32_t)(stored - dict->strings);
+        words[word_count].length = (uint32_t)term_len;
+        words[word_count].order = (uint32_t)word_count;
+        words[word_count].exact_pos = (uint32_t)pos;
+        word_count++;
+    }
+
+    size_t strings_end = dict->string_arena.used;
+    if (ok && !add_loaded_words(dict, words, word_count)) {
+        fprintf(stderr, "\nError: failed to index %s\n", filepath);
+        ok = false;
+    }
+    free(words);
+    if (ok) order_loaded_strings(dict, first_id, strings_start, strings_end);
+
+    /* Cached group sets do not know about the groups just added */
+    memset(dict->prefix_cache, 0, PREFIX_CACHE_SLOTS * sizeof(prefix_cache_slot_t));
+
+    uint32_t* group_seen = realloc(dict->group_seen, (dict->group_count + 1) * sizeof(uint32_t));
+    if (group_seen) {
+        memset(group_seen, 0, (dict->group_count + 1) * sizeof(uint32_t));
+        dict->group_seen = group_seen;
+        dict->lookup_stamp = 0;
+    } else {
+        perror("symspell_load_dictionary failed: realloc group_seen");
+        ok = false;
+    }
+    found_group_t* found = c_reallocarray(dict->found_groups, dict->group_count + 1,
+                                          sizeof(found_group_t));
+    if (found) {
+        dict->found_groups = found;
+        dict->found_capacity = dict->group_count + 1;
+    } else {
+        perror("symspell_load_dictionary failed: realloc found_groups");
+        ok = false;
     }
 
     fprintf(stderr, "\nCalculating probabilities (total words: %llu)...\n", 
@@ -656,35 +1356,990 @@ bool symspell_load_dictionary(
 
     fprintf(stderr, "\rLoaded %zu words, %zu deletes\n", 
             dict->word_count, dict->entry_count);
+    dict->strings_size = dict->string_arena.used;
+    SYMSPELL_PROBE2(load__done, dict->word_count, dict->entry_count);
 
+    if (c_reader_error(reader)) {
+        fprintf(stderr, "Error reading %s\n", filepath);
+        ok = false;
+    }
+    c_reader_close(reader);
     fclose(fp);
+    return ok;
+}
+
+/* --- Binary Index --- */
+
+static uint64_t index_align(uint64_t offset) {
+    return (offset + INDEX_ALIGN - 1) & ~(uint64_t)(INDEX_ALIGN - 1);
+}
+
+/* Zero-pad the file up to the start of the next section */
+static bool index_pad_to(FILE* fp, uint64_t* written, uint64_t offset) {
+    while (*written < offset) {
+        if (fputc(0, fp) == EOF) return false;
+        (*written)++;
+    }
+    return *written == offset;
+}
+
+static bool index_write(FILE* fp, uint64_t* written, const void* data, size_t size) {
+    if (size > 0 && fwrite(data, 1, size, fp) != size) return false;
+    *written += size;
     return true;
 }
 
-#ifdef DO_SORT
-/* Comparison function for sorting suggestions */
-static int compare_suggestions(const void* a, const void* b) {
-    const symspell_suggestion_t* sa = a;
-    const symspell_suggestion_t* sb = b;
-    if (sa->distance != sb->distance) return sa->distance - sb->distance;
-    if (sa->frequency != sb->frequency) return (sa->frequency > sb->frequency) ? -1 : 1;
-    return strcmp(sa->term, sb->term);
+/* True when an entry's key is NUL-padded inline or a string of key_length bytes */
+static bool index_key_ok(const symspell_dict_t* dict, const index_entry_t* e) {
+    if (e->key_length <= DELETE_INLINE_KEY) {
+        const unsigned char* key = (const unsigned char*)e->key;
+        for (size_t i = e->key_length; i < sizeof(e->key); i++) {
+            if (key[i] != 0) return false;
+        }
+        return memchr(key, 0, e->key_length) == NULL;
+    }
+    return e->key[0] < dict->strings_size &&
+           e->key_length < dict->strings_size - e->key[0] &&
+           strlen(dict->strings + e->key[0]) == e->key_length;
 }
-#endif
 
-/* Lookup suggestions */
-int symspell_lookup(
-    const symspell_dict_t* dict, const char* term, int max_edit_distance_lookup,
-    symspell_suggestion_t* suggestions, int max_suggestions
-) {
-    if (!dict || !term || !suggestions || max_suggestions <= 0) return 0;
+/*
+ * Build entry n of a loaded image into *entry. Only the entry itself is
+ * checked, its key and the range of its postings; the group IDs in them
+ * are checked where they are used. False when it is corrupt.
+ */
+static bool index_entry_load(const symspell_dict_t* dict, size_t n, delete_entry_t* entry) {
+    const index_entry_t* e = &dict->index_entries[n];
+    if (!index_key_ok(dict, e) || e->first > dict->index_posting_count ||
+        e->count > dict->index_posting_count - e->first) {
+        return false;
+    }
+    entry->key_length = e->key_length;
+    if (e->key_length <= DELETE_INLINE_KEY) {
+        memcpy(entry->key.words, e->key, sizeof(entry->key.words));
+    } else {
+        entry->key.str = dict->strings + e->key[0];
+    }
+    entry->count = e->count;
+    if (e->count <= ENTRY_INLINE_POSTINGS) {
+        memcpy(entry->postings.inline_groups, dict->index_postings + e->first,
+               e->count * sizeof(uint32_t));
+    } else {
+        entry->postings.groups = (uint32_t*)(dict->index_postings + e->first);
+    }
+    return true;
+}
 
-    pthread_mutex_lock((pthread_mutex_t*)&dict->lookup_mutex);
-    
-    char query[SYMSPELL_MAX_TERM_LENGTH];
-    strncpy(query, term, sizeof(query) - 1);
-    query[sizeof(query) - 1] = '\0';
-    str_tolower(query);
+/*
+ * Delete entry n in creation order: from the entry arena, or built into
+ * *scratch from a loaded image. NULL when the image's entry is corrupt.
+ */
+static const delete_entry_t* dict_entry(const symspell_dict_t* dict, size_t n,
+                                        delete_entry_t* scratch) {
+    if (!dict->index_slots) return &((const delete_entry_t*)dict->entry_arena.memory)[n];
+    return index_entry_load(dict, n, scratch) ? scratch : NULL;
+}
+
+/* Entry number + 1 in delete table slot i; an image's corrupt slot reads as empty */
+static inline uint32_t table_slot(const symspell_dict_t* dict, size_t i) {
+    if (dict->index_slots) {
+        uint32_t slot = dict->index_slots[i];
+        return slot <= dict->entry_count ? slot : INDEX_SLOT_EMPTY;
+    }
+    const delete_entry_t* entry = dict->table[i];
+    return entry ? (uint32_t)(entry - (const delete_entry_t*)dict->entry_arena.memory) + 1
+                 : INDEX_SLOT_EMPTY;
+}
+
+/*
+ * The entry in delete table slot i, NULL when empty. An image's is built
+ * into *scratch, and a corrupt one reads as empty, ending the probe.
+ */
+static inline const delete_entry_t* table_entry(const symspell_dict_t* dict, size_t i,
+                                                delete_entry_t* scratch) {
+    if (!dict->index_slots) return dict->table[i];
+    uint32_t slot = table_slot(dict, i);
+    return slot == INDEX_SLOT_EMPTY ? NULL : dict_entry(dict, slot - 1, scratch);
+}
+
+/* True when group g of a loaded image and all its words lie inside the image */
+static bool index_group_ok(const symspell_dict_t* dict, size_t g) {
+    const prefix_group_t* group = &dict->groups[g];
+    if (group->first > dict->word_table_count ||
+        group->count > dict->word_table_count - group->first) {
+        return false;
+    }
+    for (uint32_t w = group->first; w < group->first + group->count; w++) {
+        const word_entry_t* word = &dict->word_table[w];
+        if (word->offset >= dict->strings_size ||
+            word->length >= dict->strings_size - word->offset) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*
+ * True when a lookup may verify prefix group g. An image's groups are
+ * checked the first time a lookup reaches them, so a load only reads its
+ * hot part (caller holds lookup_mutex); a corrupt group is skipped.
+ */
+static inline bool group_usable(symspell_dict_t* dict, uint32_t g) {
+    if (!dict->group_checked) return true;
+    if (dict->group_checked[g] == GROUP_UNCHECKED) {
+        dict->group_checked[g] = index_group_ok(dict, g) ? GROUP_VALID : GROUP_CORRUPT;
+    }
+    return dict->group_checked[g] == GROUP_VALID;
+}
+
+/* The n items marked in hot (none when hot is NULL) first, then the rest */
+static uint32_t* index_order(const uint8_t* hot, size_t n, size_t* hot_count) {
+    uint32_t* order = malloc((n ? n : 1) * sizeof(uint32_t));
+    if (!order) return NULL;
+    size_t next = 0;
+    for (size_t i = 0; hot && i < n; i++) {
+        if (hot[i]) order[next++] = (uint32_t)i;
+    }
+    *hot_count = next;
+    for (size_t i = 0; i < n; i++) {
+        if (!hot || !hot[i]) order[next++] = (uint32_t)i;
+    }
+    return order;
+}
+
+/* Position of each item in an order */
+static uint32_t* index_rank(const uint32_t* order, size_t n) {
+    uint32_t* rank = order ? malloc((n ? n : 1) * sizeof(uint32_t)) : NULL;
+    if (!rank) return NULL;
+    for (size_t k = 0; k < n; k++) rank[order[k]] = (uint32_t)k;
+    return rank;
+}
+
+/*
+ * Write an index image. Entries and prefix groups are written in the given
+ * orders (the postings and words follow theirs), and group IDs in the
+ * postings are renumbered through group_rank.
+ */
+static bool index_write_image(const symspell_dict_t* dict, FILE* fp, const index_header_t* h,
+                              const uint32_t* entry_order, const uint32_t* entry_rank,
+                              const uint32_t* group_order, const uint32_t* group_rank) {
+    uint64_t written = 0;
+    bool ok = index_write(fp, &written, h, sizeof(*h));
+
+    ok = ok && index_pad_to(fp, &written, h->slots_off);
+    for (size_t i = 0; ok && i < dict->table_size; i++) {
+        uint32_t slot = table_slot(dict, i);
+        if (slot != INDEX_SLOT_EMPTY) slot = entry_rank[slot - 1] + 1;
+        ok = index_write(fp, &written, &slot, sizeof(slot));
+    }
+
+    ok = ok && index_pad_to(fp, &written, h->entries_off);
+    uint64_t first = 0;
+    delete_entry_t scratch;
+    for (size_t k = 0; ok && k < dict->entry_count; k++) {
+        const delete_entry_t* entry = dict_entry(dict, entry_order[k], &scratch);
+        if (!entry) {
+            ok = false;
+            break;
+        }
+        index_entry_t e = { { 0, 0 }, entry->key_length, entry->count, first };
+        if (entry->key_length <= DELETE_INLINE_KEY) {
+            memcpy(e.key, entry->key.words, sizeof(e.key));
+        } else {
+            e.key[0] = (uint64_t)(entry->key.str - dict->strings);
+        }
+        ok = index_write(fp, &written, &e, sizeof(e));
+        first += entry->count;
+    }
+
+    ok = ok && index_pad_to(fp, &written, h->posting_groups_off);
+    for (size_t k = 0; ok && k < dict->entry_count; k++) {
+        const delete_entry_t* entry = dict_entry(dict, entry_order[k], &scratch);
+        if (!entry) {
+            ok = false;
+            break;
+        }
+        const uint32_t* postings = entry_postings(entry);
+        uint32_t chunk[256];
+        for (uint32_t p = 0; ok && p < entry->count; ) {
+            uint32_t n = 0;
+            for (; ok && n < 256 && p < entry->count; n++, p++) {
+                /* Group IDs of a loaded image are not checked at load */
+                uint32_t group_id = postings[p] & POSTING_GROUP_MASK;
+                ok = group_id < dict->group_count;
+                chunk[n] = ok ? (postings[p] & ~POSTING_GROUP_MASK) | group_rank[group_id] : 0;
+            }
+            ok = ok && index_write(fp, &written, chunk, n * sizeof(uint32_t));
+        }
+    }
+
+    ok = ok && index_pad_to(fp, &written, h->groups_off);
+    uint32_t word = 0;
+    for (size_t k = 0; ok && k < dict->group_count; k++) {
+        prefix_group_t g = { word, dict->groups[group_order[k]].count };
+        ok = index_write(fp, &written, &g, sizeof(g));
+        word += g.count;
+    }
+    ok = ok && index_pad_to(fp, &written, h->word_table_off);
+    for (size_t k = 0; ok && k < dict->group_count; k++) {
+        const prefix_group_t* g = &dict->groups[group_order[k]];
+        ok = index_write(fp, &written, &dict->word_table[g->first], g->count * sizeof(word_entry_t));
+    }
+
+    size_t exact_size = dict->exact_table->table_size;
+    ok = ok && index_pad_to(fp, &written, h->exact_hashes_off) &&
+         index_write(fp, &written, dict->exact_table->hashes, exact_size * sizeof(uint64_t));
+    ok = ok && index_pad_to(fp, &written, h->exact_freqs_off) &&
+         index_write(fp, &written, dict->exact_table->frequencies, exact_size * sizeof(uint64_t));
+    ok = ok && index_pad_to(fp, &written, h->exact_probs_off) &&
+         index_write(fp, &written, dict->exact_table->probabilities, exact_size * sizeof(float));
+    ok = ok && index_pad_to(fp, &written, h->exact_iwf_off) &&
+         index_write(fp, &written, dict->exact_table->iwf, exact_size * sizeof(float));
+    ok = ok && index_pad_to(fp, &written, h->strings_off) &&
+         index_write(fp, &written, dict->strings, dict->strings_size);
+    return ok && written == h->file_size;
+}
+
+/*
+ * Save an index image with the entries and prefix groups marked in
+ * hot_entries and hot_groups (NULL: none) at the front of their sections.
+ * Both parts keep creation order, so without marks entries stay hottest
+ * prefix group first (see add_loaded_words).
+ */
+static bool index_save(const symspell_dict_t* dict, const char* filepath,
+                       const uint8_t* hot_entries, const uint8_t* hot_groups) {
+    index_header_t h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, INDEX_MAGIC, INDEX_MAGIC_SIZE);
+    h.version = INDEX_VERSION;
+    h.byte_order = INDEX_BYTE_ORDER;
+    h.max_edit_distance = (uint32_t)dict->max_edit_distance;
+    h.prefix_length = (uint32_t)dict->prefix_length;
+    h.word_count = dict->word_count;
+    h.table_size = dict->table_size;
+    h.exact_table_size = dict->exact_table->table_size;
+    h.group_count = dict->group_count;
+    h.word_table_count = dict->word_table_count;
+    h.strings_size = dict->strings_size;
+    memcpy(h.symbols, dict->symbols, sizeof(h.symbols));
+
+    size_t hot_entry_count = 0, hot_group_count = 0;
+    uint32_t* entry_order = index_order(hot_entries, dict->entry_count, &hot_entry_count);
+    uint32_t* entry_rank = index_rank(entry_order, dict->entry_count);
+    uint32_t* group_order = index_order(hot_groups, dict->group_count, &hot_group_count);
+    uint32_t* group_rank = index_rank(group_order, dict->group_count);
+    if (!entry_rank || !group_rank) {
+        perror("symspell_save_index failed: malloc order");
+        free(entry_order);
+        free(entry_rank);
+        free(group_order);
+        free(group_rank);
+        return false;
+    }
+
+    /* A loaded image was only partly checked; check the rest before writing */
+    bool valid = true;
+    for (size_t g = 0; dict->group_checked && valid && g < dict->group_count; g++) {
+        valid = dict->group_checked[g] == GROUP_VALID || index_group_ok(dict, g);
+    }
+    h.entry_count = dict->entry_count;
+    h.hot_entry_count = hot_entry_count;
+    delete_entry_t scratch;
+    for (size_t k = 0; valid && k < dict->entry_count; k++) {
+        const delete_entry_t* entry = dict_entry(dict, entry_order[k], &scratch);
+        valid = entry != NULL;
+        if (valid) h.posting_count += entry->count;
+        if (k + 1 == hot_entry_count) h.hot_posting_count = h.posting_count;
+    }
+    if (!valid) {
+        fprintf(stderr, "Error: cannot save %s: the loaded index is corrupt\n", filepath);
+        free(entry_order);
+        free(entry_rank);
+        free(group_order);
+        free(group_rank);
+        return false;
+    }
+    h.hot_group_count = hot_group_count;
+    for (size_t k = 0; k < hot_group_count; k++) h.hot_word_count += dict->groups[group_order[k]].count;
+
+    uint64_t off = index_align(sizeof(h));
+    h.slots_off = off;          off = index_align(off + h.table_size * sizeof(uint32_t));
+    h.entries_off = off;        off = index_align(off + h.entry_count * sizeof(index_entry_t));
+    h.posting_groups_off = off; off = index_align(off + h.posting_count * sizeof(uint32_t));
+    h.groups_off = off;         off = index_align(off + h.group_count * sizeof(prefix_group_t));
+    h.word_table_off = off;     off = index_align(off + h.word_table_count * sizeof(word_entry_t));
+    h.exact_hashes_off = off;   off = index_align(off + h.exact_table_size * sizeof(uint64_t));
+    h.exact_freqs_off = off;    off = index_align(off + h.exact_table_size * sizeof(uint64_t));
+    h.exact_probs_off = off;    off = index_align(off + h.exact_table_size * sizeof(float));
+    h.exact_iwf_off = off;      off = index_align(off + h.exact_table_size * sizeof(float));
+    h.strings_off = off;        off = off + h.strings_size;
+    h.file_size = off;
+
+    bool ok = false;
+    FILE* fp = fopen(filepath, "wb");
+    if (!fp) {
+        fprintf(stderr, "Error opening %s for writing: %s\n", filepath, strerror(errno));
+    } else {
+        ok = index_write_image(dict, fp, &h, entry_order, entry_rank, group_order, group_rank);
+        if (fclose(fp) != 0) ok = false;
+        if (!ok) {
+            fprintf(stderr, "Error writing index %s\n", filepath);
+            remove(filepath);
+        }
+    }
+    free(entry_order);
+    free(entry_rank);
+    free(group_order);
+    free(group_rank);
+    return ok;
+}
+
+/* Save the built dictionary as an index image for symspell_load_index() */
+bool symspell_save_index(const symspell_dict_t* dict, const char* filepath) {
+    if (!dict || !filepath) return false;
+    return index_save(dict, filepath, NULL, NULL);
+}
+
+/* Entry number + 1 of a delete; INDEX_SLOT_EMPTY when the table does not hold it */
+static uint32_t find_delete_slot(const symspell_dict_t* dict, const char* str, size_t len) {
+    delete_key_t key;
+    pack_delete_key(&key, str, len);
+    uint64_t hash = xxh3(str, len);
+    for (size_t i = 0; i < dict->table_size; i++) {
+        size_t idx = (hash + i) % dict->table_size;
+        delete_entry_t scratch;
+        const delete_entry_t* entry = table_entry(dict, idx, &scratch);
+        if (!entry) return INDEX_SLOT_EMPTY;
+        if (entry_key_equals(entry, &key, len)) return table_slot(dict, idx);
+    }
+    return INDEX_SLOT_EMPTY;
+}
+
+/*
+ * Save an index image laid out for a sample of traffic: explain every
+ * query and mark the entries its deletes hit, and the prefix groups their
+ * postings lead the lookup to verify, as hot
+ */
+bool symspell_save_index_profiled(
+    const symspell_dict_t* dict, const char* filepath,
+    const char* const* queries, size_t query_count, int max_edit_distance
+) {
+    if (!dict || !filepath || (!queries && query_count > 0)) return false;
+
+    uint8_t* hot_entries = calloc(dict->entry_count + 1, 1);
+    uint8_t* hot_groups = calloc(dict->group_count + 1, 1);
+    if (!hot_entries || !hot_groups) {
+        perror("symspell_save_index_profiled failed: calloc marks");
+        free(hot_entries);
+        free(hot_groups);
+        return false;
+    }
+
+    for (size_t q = 0; q < query_count; q++) {
+        symspell_suggestion_t suggestion;
+        symspell_explain_t explain;
+        symspell_lookup_explain(dict, queries[q], max_edit_distance, &suggestion, 1, &explain);
+        for (size_t d = 0; d < explain.delete_count; d++) {
+            const symspell_explain_delete_t* del = &explain.deletes[d];
+            uint32_t slot = del->hit
+                ? find_delete_slot(dict, del->delete_str, strlen(del->delete_str))
+                : INDEX_SLOT_EMPTY;
+            delete_entry_t scratch;
+            const delete_entry_t* entry =
+                slot != INDEX_SLOT_EMPTY ? dict_entry(dict, slot - 1, &scratch) : NULL;
+            if (!entry) continue;
+            hot_entries[slot - 1] = 1;
+            const uint32_t* postings = entry_postings(entry);
+            for (uint32_t p = 0; p < entry->count; p++) {
+                uint32_t group_id = postings[p] & POSTING_GROUP_MASK;
+                if (group_id < dict->group_count &&
+                    postings[p] >> POSTING_DEPTH_SHIFT <= (uint32_t)explain.max_edit_distance) {
+                    hot_groups[group_id] = 1;
+                }
+            }
+        }
+        symspell_explain_free(&explain);
+    }
+
+    bool ok = index_save(dict, filepath, hot_entries, hot_groups);
+    free(hot_entries);
+    free(hot_groups);
+    return ok;
+}
+
+/* True when [off, off + count * size) lies inside the image and is aligned */
+static bool index_section_ok(const index_header_t* h, uint64_t off, uint64_t count, size_t size) {
+    if (off % INDEX_ALIGN != 0 || off > h->file_size) return false;
+    if (size > 0 && count > (h->file_size - off) / size) return false;
+    return true;
+}
+
+static bool index_header_ok(const index_header_t* h, size_t file_size) {
+    return memcmp(h->magic, INDEX_MAGIC, INDEX_MAGIC_SIZE) == 0 &&
+           h->version == INDEX_VERSION &&
+           h->byte_order == INDEX_BYTE_ORDER &&
+           h->file_size == file_size &&
+           h->strings_size > 0 &&
+           h->strings_size <= UINT32_MAX &&
+           h->posting_count <= UINT64_MAX / sizeof(uint32_t) &&
+           h->group_count <= UINT32_MAX &&
+           h->word_table_count < WORD_PENDING &&
+           h->exact_table_size == EXACT_MATCH_TABLE_SIZE &&
+           h->hot_entry_count <= h->entry_count &&
+           h->hot_posting_count <= h->posting_count &&
+           h->hot_group_count <= h->group_count &&
+           h->hot_word_count <= h->word_table_count &&
+           index_section_ok(h, h->slots_off, h->table_size, sizeof(uint32_t)) &&
+           index_section_ok(h, h->entries_off, h->entry_count, sizeof(index_entry_t)) &&
+           index_section_ok(h, h->posting_groups_off, h->posting_count, sizeof(uint32_t)) &&
+           index_section_ok(h, h->groups_off, h->group_count, sizeof(prefix_group_t)) &&
+           index_section_ok(h, h->word_table_off, h->word_table_count, sizeof(word_entry_t)) &&
+           index_section_ok(h, h->exact_hashes_off, h->exact_table_size, sizeof(uint64_t)) &&
+           index_section_ok(h, h->exact_freqs_off, h->exact_table_size, sizeof(uint64_t)) &&
+           index_section_ok(h, h->exact_probs_off, h->exact_table_size, sizeof(float)) &&
+           index_section_ok(h, h->exact_iwf_off, h->exact_table_size, sizeof(float)) &&
+           index_section_ok(h, h->strings_off, h->strings_size, 1);
+}
+
+/* posix_madvise() the pages covering [off, off + size) of a mapped image */
+static void index_advise(void* image, uint64_t off, uint64_t size, int advice) {
+    if (size == 0) return;
+    uint64_t page = (uint64_t)sysconf(_SC_PAGESIZE);
+    uint64_t start = off - off % page;
+    posix_madvise((char*)image + start, (size_t)(off + size - start), advice);
+}
+
+/* Read the whole file into a heap buffer */
+static void* index_read_file(int fd, size_t size) {
+    char* image = malloc(size);
+    if (!image) return NULL;
+    size_t done = 0;
+    while (done < size) {
+        ssize_t n = read(fd, image + done, size - done);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) {
+            free(image);
+            return NULL;
+        }
+        done += (size_t)n;
+    }
+    return image;
+}
+
+/* Load a dictionary from an index image written by symspell_save_index() */
+symspell_dict_t* symspell_load_index(const char* filepath, symspell_index_mode_t mode) {
+    if (!filepath) return NULL;
+    SYMSPELL_PROBE2(index__load__start, filepath, mode == SYMSPELL_INDEX_MMAP);
+
+    int fd = open(filepath, O_RDONLY);
+    if (fd < 0) {
+        fprintf(stderr, "Error opening index %s: %s\n", filepath, strerror(errno));
+        return NULL;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(index_header_t)) {
+        fprintf(stderr, "Error: %s is not a SymSpell index\n", filepath);
+        close(fd);
+        return NULL;
+    }
+    size_t image_size = (size_t)st.st_size;
+
+    void* image;
+    if (mode == SYMSPELL_INDEX_MMAP) {
+        image = mmap(NULL, image_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (image == MAP_FAILED) image = NULL;
+    } else {
+        image = index_read_file(fd, image_size);
+    }
+    close(fd);
+    if (!image) {
+        fprintf(stderr, "Error reading index %s: %s\n", filepath, strerror(errno));
+        return NULL;
+    }
+
+    const char* base = image;
+    const index_header_t* h = image;
+    symspell_dict_t* dict = NULL;
+    if (index_header_ok(h, image_size) && base[h->strings_off + h->strings_size - 1] == '\0') {
+        dict = dict_new((int)h->max_edit_distance, (int)h->prefix_length);
+    }
+    if (!dict || dict->table_size != h->table_size) {
+        fprintf(stderr, "Error: %s is not a valid SymSpell index\n", filepath);
+        if (dict) symspell_destroy(dict);
+        if (mode == SYMSPELL_INDEX_MMAP) munmap(image, image_size); else free(image);
+        return NULL;
+    }
+
+    /* From here on symspell_destroy() releases the image */
+    dict->index_image = image;
+    dict->index_image_size = image_size;
+    dict->index_mapped = (mode == SYMSPELL_INDEX_MMAP);
+    dict->strings = base + h->strings_off;
+    dict->strings_size = h->strings_size;
+    dict->word_count = h->word_count;
+
+    /* The image is never written; loading into it is refused */
+    dict->exact_table->hashes = (uint64_t*)(base + h->exact_hashes_off);
+    dict->exact_table->frequencies = (uint64_t*)(base + h->exact_freqs_off);
+    dict->exact_table->probabilities = (float*)(base + h->exact_probs_off);
+    dict->exact_table->iwf = (float*)(base + h->exact_iwf_off);
+
+    /* The delete table is read in place; slots and entries are checked as
+     * lookups probe them */
+    free(dict->table);
+    dict->table = NULL;
+    dict->index_slots = (const uint32_t*)(base + h->slots_off);
+    dict->index_entries = (const index_entry_t*)(base + h->entries_off);
+    dict->index_postings = (const uint32_t*)(base + h->posting_groups_off);
+    dict->index_posting_count = h->posting_count;
+    dict->entry_count = h->entry_count;
+
+    dict->groups = (prefix_group_t*)(base + h->groups_off);
+    dict->group_count = h->group_count;
+    dict->word_table = (word_entry_t*)(base + h->word_table_off);
+    dict->word_table_count = h->word_table_count;
+    for (size_t b = 0; b < 256; b++) {
+        if (h->symbols[b] > ALPHABET_MAX) {
+            fprintf(stderr, "Error: %s: corrupt alphabet\n", filepath);
+            symspell_destroy(dict);
+            return NULL;
+        }
+        dict->symbols[b] = h->symbols[b];
+        if (h->symbols[b] > dict->symbol_count) dict->symbol_count = h->symbols[b];
+    }
+    dict->group_seen = calloc(dict->group_count + 1, sizeof(uint32_t));
+    dict->group_checked = calloc(dict->group_count + 1, 1);
+    dict->found_groups = calloc(dict->group_count + 1, sizeof(found_group_t));
+    if (!dict->group_seen || !dict->group_checked || !dict->found_groups) {
+        perror("symspell_load_index failed: calloc dict->group_seen");
+        symspell_destroy(dict);
+        return NULL;
+    }
+    dict->found_capacity = dict->group_count + 1;
+
+    /*
+     * A profiled image: start reading its hot entries, postings, groups and
+     * words in now. The slots and the cold part keep normal readahead;
+     * faulting them in page by page cost a cold lookup a major fault for
+     * nearly every page it touched
+     */
+    if (mode == SYMSPELL_INDEX_MMAP && h->hot_entry_count > 0) {
+        index_advise(image, h->entries_off, h->hot_entry_count * sizeof(index_entry_t),
+                     POSIX_MADV_WILLNEED);
+        index_advise(image, h->posting_groups_off, h->hot_posting_count * sizeof(uint32_t),
+                     POSIX_MADV_WILLNEED);
+        index_advise(image, h->groups_off, h->hot_group_count * sizeof(prefix_group_t),
+                     POSIX_MADV_WILLNEED);
+        index_advise(image, h->word_table_off, h->hot_word_count * sizeof(word_entry_t),
+                     POSIX_MADV_WILLNEED);
+    }
+
+    /* Only the hot part is checked here; lookups check the rest as they
+     * reach it (see table_entry and group_usable) */
+    for (size_t g = 0; g < h->hot_group_count; g++) {
+        if (!index_group_ok(dict, g)) {
+            fprintf(stderr, "Error: %s: corrupt group %zu\n", filepath, g);
+            symspell_destroy(dict);
+            return NULL;
+        }
+        dict->group_checked[g] = GROUP_VALID;
+    }
+    for (size_t i = 0; i < h->hot_entry_count; i++) {
+        delete_entry_t entry;
+        if (!index_entry_load(dict, i, &entry)) {
+            fprintf(stderr, "Error: %s: corrupt entry %zu\n", filepath, i);
+            symspell_destroy(dict);
+            return NULL;
+        }
+    }
+    SYMSPELL_PROBE2(index__load__done, dict->word_count, dict->entry_count);
+    return dict;
+}
+
+#ifdef DO_SORT
+/* Comparison function for sorting suggestions */
+static int compare_suggestions(const void* a, const void* b) {
+    const symspell_suggestion_t* sa = a;
+    const symspell_suggestion_t* sb = b;
+    if (sa->distance != sb->distance) return sa->distance - sb->distance;
+    if (sa->frequency != sb->frequency) return (sa->frequency > sb->frequency) ? -1 : 1;
+    return strcmp(sa->term, sb->term);
+}
+#endif
+
+/* Read a clock as nanoseconds */
+static uint64_t clock_ns(clockid_t clock) {
+    struct timespec ts;
+    clock_gettime(clock, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/* --- Explain Trace Helpers (only reached when explain != NULL) --- */
+
+static void explain_add_delete(symspell_explain_t* explain, const char* delete_str,
+                               int depth) {
+    if (explain->delete_count % EXPLAIN_GROWTH == 0) {
+        symspell_explain_delete_t* grown = realloc(explain->deletes,
+            (explain->delete_count + EXPLAIN_GROWTH) * sizeof(symspell_explain_delete_t));
+        if (!grown) {
+            explain->truncated = true;
+            return;
+        }
+        explain->deletes = grown;
+    }
+    symspell_explain_delete_t* d = &explain->deletes[explain->delete_count++];
+    memset(d, 0, sizeof(*d));
+    snprintf(d->delete_str, sizeof(d->delete_str), "%s", delete_str);
+    d->depth = depth;
+}
+
+static void explain_add_candidate(symspell_explain_t* explain, const char* word,
+                                  uint64_t freq, int distance, int max_distance) {
+    if (explain->candidate_count % EXPLAIN_GROWTH == 0) {
+        symspell_explain_candidate_t* grown = realloc(explain->candidates,
+            (explain->candidate_count + EXPLAIN_GROWTH) * sizeof(symspell_explain_candidate_t));
+        if (!grown) {
+            explain->truncated = true;
+            return;
+        }
+        explain->candidates = grown;
+    }
+    symspell_explain_candidate_t* c = &explain->candidates[explain->candidate_count++];
+    snprintf(c->term, sizeof(c->term), "%s", word);
+    c->frequency = freq;
+    c->distance = distance;
+    c->delete_index = explain->delete_count - 1;
+    c->accepted = distance <= max_distance;
+    if (c->accepted) explain->accepted++;
+}
+
+/* Describe why the top suggestion beat the other accepted candidates */
+static void explain_rank(symspell_explain_t* explain, const symspell_suggestion_t* best) {
+    explain->winner = -1;
+    size_t same_distance = 0;
+    const symspell_explain_candidate_t* runner_up = NULL;
+    for (size_t i = 0; i < explain->candidate_count; i++) {
+        const symspell_explain_candidate_t* c = &explain->candidates[i];
+        if (!c->accepted) continue;
+        if (explain->winner < 0 && strcmp(c->term, best->term) == 0) {
+            explain->winner = (long)i;
+            continue;
+        }
+        if (c->distance == best->distance) {
+            same_distance++;
+            if (!runner_up || c->frequency > runner_up->frequency ||
+                (c->frequency == runner_up->frequency && strcmp(c->term, runner_up->term) < 0)) {
+                runner_up = c;
+            }
+        }
+    }
+
+    if (!runner_up) {
+        snprintf(explain->reason, sizeof(explain->reason),
+                 "only candidate at distance %d (%zu accepted in total)",
+                 best->distance, explain->accepted);
+    } else if (runner_up->frequency == best->frequency) {
+        snprintf(explain->reason, sizeof(explain->reason),
+                 "distance %d, frequency %llu ties with '%s'; alphabetical order wins",
+                 best->distance, (unsigned long long)best->frequency, runner_up->term);
+    } else {
+        snprintf(explain->reason, sizeof(explain->reason),
+                 "smallest distance %d (%zu other candidate(s) at it); highest "
+                 "frequency %llu beats '%s' (%llu)",
+                 best->distance, same_distance, (unsigned long long)best->frequency,
+                 runner_up->term, (unsigned long long)runner_up->frequency);
+    }
+}
+
+/*
+ * Prefix cache key of a fuzzy search. Deletes are generated from the first
+ * prefix_length characters only, so every query sharing them (and the
+ * distance) reaches the same prefix groups. Like the exact table, the cache
+ * trusts the 64-bit hash and keeps no copy of the prefix.
+ */
+static uint64_t prefix_cache_key(const char* query, int prefix_len, int max_edit_distance) {
+    uint64_t key = xxh3(query, (size_t)prefix_len) ^
+                   ((uint64_t)max_edit_distance * 0x9E3779B97F4A7C15ULL);
+    return key ? key : 1;
+}
+
+/*
+ * Verify every word of one prefix group against the query and append the
+ * ones within max_edit_distance to candidates. Words no longer than
+ * prefix_length are at short_distance when that is not -1.
+ *
+ * Returns: The new candidate count
+ */
+static SYMSPELL_ALWAYS_INLINE int verify_group(
+    const symspell_dict_t* dict, uint32_t group_id, const char* query, int query_len,
+    const query_pattern_t* pattern, int max_edit_distance, int short_distance,
+    symspell_suggestion_t* candidates, int candidate_count, size_t* postings_visited,
+    symspell_explain_t* explain
+) {
+    /* Interned words are distinct and groups disjoint, so no candidate can
+     * be reached twice */
+    const prefix_group_t* group = &dict->groups[group_id];
+    for (uint32_t w = group->first;
+         w < group->first + group->count && candidate_count < MAX_CANDIDATES_PER_LOOKUP;
+         w++) {
+        const word_entry_t* entry_word = &dict->word_table[w];
+        const char* word = dict->strings + entry_word->offset;
+        (*postings_visited)++;
+        uint64_t verify_start = 0;
+        if (explain) verify_start = clock_ns(CLOCK_MONOTONIC);
+        int length_gap = abs((int)entry_word->length - query_len);
+        int dist;
+        if (length_gap > max_edit_distance) {
+            dist = max_edit_distance + 1;
+        } else if (short_distance >= 0 && entry_word->length <= (uint32_t)dict->prefix_length) {
+            dist = short_distance;
+        } else if (pattern->length && entry_word->packed[0] &&
+                   entry_word->length <= PACKED_WORD_MAX) {
+            dist = packed_distance(pattern, entry_word, max_edit_distance);
+        } else {
+            dist = edit_distance(query, word, max_edit_distance);
+        }
+        if (explain) {
+            explain->verify_ns += clock_ns(CLOCK_MONOTONIC) - verify_start;
+            explain->postings_visited++;
+        }
+        if (dist <= max_edit_distance) {
+            strncpy(candidates[candidate_count].term, word, SYMSPELL_MAX_TERM_LENGTH - 1);
+            candidates[candidate_count].frequency = entry_word->frequency;
+            candidates[candidate_count].distance = dist;
+            candidate_count++;
+        }
+        if (explain) {
+            explain_add_candidate(explain, word, entry_word->frequency,
+                                  dist, max_edit_distance);
+        }
+    }
+    return candidate_count;
+}
+
+/*
+ * Helper-thread pool for the verification stage of heavy lookups. The
+ * lookup thread splits the queue of found groups into contiguous chunks
+ * of about equal word count, keeps the first and hands one to each
+ * helper; every chunk collects its candidates in queue order into its
+ * own buffer, and the buffers are concatenated in chunk order. The
+ * result is exactly the sequential one, including which candidates
+ * survive MAX_CANDIDATES_PER_LOOKUP. One job runs at a time: lookups
+ * hold lookup_mutex.
+ */
+typedef struct {
+    pthread_t thread;
+    struct verify_pool* pool;
+    uint64_t seen_generation;
+    size_t first;                       /* Chunk: found[first .. end) */
+    size_t end;
+    symspell_suggestion_t* candidates;  /* MAX_CANDIDATES_PER_LOOKUP */
+    int candidate_count;
+    size_t postings_visited;
+} verify_worker_t;
+
+typedef struct verify_pool {
+    pthread_mutex_t lock;
+    pthread_cond_t start;               /* New generation or shutdown */
+    pthread_cond_t done;                /* pending reached 0 */
+    uint64_t generation;
+    size_t pending;
+    bool shutdown;
+
+    /* The job of the current generation */
+    const symspell_dict_t* dict;
+    const found_group_t* found;
+    const char* query;
+    int query_len;
+    const query_pattern_t* pattern;
+    int max_edit_distance;
+
+    size_t min_words;
+    size_t worker_count;
+    verify_worker_t* workers;
+} verify_pool_t;
+
+/* Verify found[first .. end) into candidates; returns the candidate count */
+static int verify_chunk(const verify_pool_t* pool, size_t first, size_t end,
+                        symspell_suggestion_t* candidates, size_t* postings_visited) {
+    int count = 0;
+    for (size_t g = first; g < end && count < MAX_CANDIDATES_PER_LOOKUP; g++) {
+        count = verify_group(pool->dict, pool->found[g].group, pool->query, pool->query_len,
+                             pool->pattern, pool->max_edit_distance,
+                             pool->found[g].short_distance, candidates, count,
+                             postings_visited, NULL);
+    }
+    return count;
+}
+
+static void* verify_worker_main(void* arg) {
+    verify_worker_t* worker = arg;
+    verify_pool_t* pool = worker->pool;
+
+    pthread_mutex_lock(&pool->lock);
+    for (;;) {
+        while (!pool->shutdown && pool->generation == worker->seen_generation) {
+            pthread_cond_wait(&pool->start, &pool->lock);
+        }
+        if (pool->shutdown) break;
+        worker->seen_generation = pool->generation;
+        pthread_mutex_unlock(&pool->lock);
+
+        worker->postings_visited = 0;
+        worker->candidate_count = verify_chunk(pool, worker->first, worker->end,
+                                               worker->candidates, &worker->postings_visited);
+
+        pthread_mutex_lock(&pool->lock);
+        if (--pool->pending == 0) pthread_cond_signal(&pool->done);
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return NULL;
+}
+
+/* Stop and join the helpers, then free the pool */
+static void verify_pool_destroy(verify_pool_t* pool) {
+    if (!pool) return;
+    pthread_mutex_lock(&pool->lock);
+    pool->shutdown = true;
+    pthread_cond_broadcast(&pool->start);
+    pthread_mutex_unlock(&pool->lock);
+
+    for (size_t i = 0; i < pool->worker_count; i++) {
+        pthread_join(pool->workers[i].thread, NULL);
+        free(pool->workers[i].candidates);
+    }
+    free(pool->workers);
+    pthread_cond_destroy(&pool->done);
+    pthread_cond_destroy(&pool->start);
+    pthread_mutex_destroy(&pool->lock);
+    free(pool);
+}
+
+static verify_pool_t* verify_pool_create(size_t threads, size_t min_words) {
+    verify_pool_t* pool = calloc(1, sizeof(verify_pool_t));
+    if (!pool) return NULL;
+    pool->workers = calloc(threads, sizeof(verify_worker_t));
+    if (!pool->workers ||
+        pthread_mutex_init(&pool->lock, NULL) != 0) {
+        free(pool->workers);
+        free(pool);
+        return NULL;
+    }
+    if (pthread_cond_init(&pool->start, NULL) != 0) {
+        pthread_mutex_destroy(&pool->lock);
+        free(pool->workers);
+        free(pool);
+        return NULL;
+    }
+    if (pthread_cond_init(&pool->done, NULL) != 0) {
+        pthread_cond_destroy(&pool->start);
+        pthread_mutex_destroy(&pool->lock);
+        free(pool->workers);
+        free(pool);
+        return NULL;
+    }
+    pool->min_words = min_words;
+
+    for (size_t i = 0; i < threads; i++) {
+        verify_worker_t* worker = &pool->workers[i];
+        worker->pool = pool;
+        worker->candidates = malloc(MAX_CANDIDATES_PER_LOOKUP * sizeof(symspell_suggestion_t));
+        if (!worker->candidates ||
+            pthread_create(&worker->thread, NULL, verify_worker_main, worker) != 0) {
+            free(worker->candidates);
+            verify_pool_destroy(pool);
+            return NULL;
+        }
+        pool->worker_count++;
+    }
+    return pool;
+}
+
+/*
+ * Verify found[0 .. found_count) with the helpers when the queue holds at
+ * least min_words words. Returns the candidate count, or -1 when the queue
+ * is too small to be worth splitting.
+ */
+static int verify_parallel(const symspell_dict_t* dict, const found_group_t* found,
+                           size_t found_count, const char* query, int query_len,
+                           const query_pattern_t* pattern, int max_edit_distance,
+                           symspell_suggestion_t* candidates, size_t* postings_visited) {
+    verify_pool_t* pool = dict->verify_pool;
+    size_t total = 0;
+    for (size_t g = 0; g < found_count; g++) total += dict->groups[found[g].group].count;
+    if (total < pool->min_words || found_count < 2) return -1;
+
+    /* Chunk c ends where the running word count passes (c + 1) / chunks of it */
+    size_t chunks = pool->worker_count + 1;
+    size_t bounds[chunks + 1];
+    bounds[0] = 0;
+    size_t chunk = 1;
+    size_t words = 0;
+    for (size_t g = 0; g < found_count && chunk < chunks; g++) {
+        words += dict->groups[found[g].group].count;
+        while (chunk < chunks && words * chunks >= total * chunk) bounds[chunk++] = g + 1;
+    }
+    while (chunk <= chunks) bounds[chunk++] = found_count;
+
+    pthread_mutex_lock(&pool->lock);
+    pool->dict = dict;
+    pool->found = found;
+    pool->query = query;
+    pool->query_len = query_len;
+    pool->pattern = pattern;
+    pool->max_edit_distance = max_edit_distance;
+    for (size_t i = 0; i < pool->worker_count; i++) {
+        pool->workers[i].first = bounds[i + 1];
+        pool->workers[i].end = bounds[i + 2];
+    }
+    pool->pending = pool->worker_count;
+    pool->generation++;
+    pthread_cond_broadcast(&pool->start);
+    pthread_mutex_unlock(&pool->lock);
+
+    int count = verify_chunk(pool, bounds[0], bounds[1], candidates, postings_visited);
+
+    pthread_mutex_lock(&pool->lock);
+    while (pool->pending > 0) pthread_cond_wait(&pool->done, &pool->lock);
+    pthread_mutex_unlock(&pool->lock);
+
+    for (size_t i = 0; i < pool->worker_count; i++) {
+        const verify_worker_t* worker = &pool->workers[i];
+        int take = worker->candidate_count;
+        if (take > MAX_CANDIDATES_PER_LOOKUP - count) take = MAX_CANDIDATES_PER_LOOKUP - count;
+        memcpy(candidates + count, worker->candidates, (size_t)take * sizeof(symspell_suggestion_t));
+        count += take;
+        *postings_visited += worker->postings_visited;
+    }
+    return count;
+}
+
+/*
+ * Lookup core shared by symspell_lookup() and symspell_lookup_explain()
+ * (caller holds lookup_mutex).
+ *
+ * Always inlined: symspell_lookup() passes a constant NULL explain, so every
+ * tracing branch below is compiled out of the normal path.
+ */
+static SYMSPELL_ALWAYS_INLINE int lookup_core(
+    const symspell_dict_t* dict, const char* term, int max_edit_distance_lookup,
+    symspell_suggestion_t* suggestions, int max_suggestions,
+    symspell_explain_t* explain
+) {
+    uint64_t stage_ns = 0;
+    if (explain) stage_ns = clock_ns(CLOCK_MONOTONIC);
+
+    char query[SYMSPELL_MAX_TERM_LENGTH];
+    strncpy(query, term, sizeof(query) - 1);
+    query[sizeof(query) - 1] = '\0';
+    str_tolower(query);
+
+    if (explain) {
+        memcpy(explain->query, query, sizeof(explain->query));
+        uint64_t now = clock_ns(CLOCK_MONOTONIC);
+        explain->normalize_ns = now - stage_ns;
+        stage_ns = now;
+    }
     
     /* FAST PATH: O(1) exact match via hash comparison */
     uint64_t query_hash = xxh3(query, strlen(query));
@@ -692,6 +2347,7 @@ int symspell_lookup(
     
     for (size_t probe = 0; probe < dict->exact_table->table_size; probe++) {
         size_t pos = (idx + probe) % dict->exact_table->table_size;
+        if (explain) explain->exact_probes++;
         
         if (dict->exact_table->hashes[pos] == 0) break;
         
@@ -702,7 +2358,13 @@ int symspell_lookup(
             suggestions[0].iwf = dict->exact_table->iwf[pos];
             strncpy(suggestions[0].term, query, SYMSPELL_MAX_TERM_LENGTH - 1);
             suggestions[0].term[SYMSPELL_MAX_TERM_LENGTH - 1] = '\0';
-            pthread_mutex_unlock((pthread_mutex_t*)&dict->lookup_mutex);
+            SYMSPELL_PROBE2(lookup__exact, strlen(query), suggestions[0].frequency);
+            if (explain) {
+                explain->exact_hit = true;
+                explain->exact_ns = clock_ns(CLOCK_MONOTONIC) - stage_ns;
+                snprintf(explain->reason, sizeof(explain->reason),
+                         "exact match in the dictionary");
+            }
             return 1;
         }
     }
@@ -714,49 +2376,208 @@ int symspell_lookup(
     if (strlen(query) <= 4) {
         max_edit_distance = 1;
     }
+
+    if (explain) {
+        explain->max_edit_distance = max_edit_distance;
+        uint64_t now = clock_ns(CLOCK_MONOTONIC);
+        explain->exact_ns = now - stage_ns;
+        stage_ns = now;
+    }
     
     symspell_suggestion_t* candidates = dict->candidate_buffer;
     int candidate_count = 0;
-    
-    size_t delete_count = _generate_all_deletes_reuse(
-        query, max_edit_distance, dict->prefix_length,
-        dict->delete_work_buffer, dict->delete_buffer_capacity
-    );
-    
-    for (size_t d = 0; d < delete_count; d++) {
-        uint64_t hash = xxh3(dict->delete_work_buffer[d], strlen(dict->delete_work_buffer[d]));
-        for (size_t probe = 0; probe < dict->table_size; probe++) {
-            size_t idx = (hash + probe) % dict->table_size;
-            if (!dict->table[idx]) break;
-            
-            if (strcmp(dict->table[idx]->delete_str, dict->delete_work_buffer[d]) == 0) {
-                delete_entry_t* entry = dict->table[idx];
-                for (size_t j = 0; j < entry->count && candidate_count < MAX_CANDIDATES_PER_LOOKUP; j++) {
-                    int dist = edit_distance(query, entry->words[j], max_edit_distance);
-                    if (dist <= max_edit_distance) {
-                        bool found = false;
-                        for (int c = 0; c < candidate_count; c++) {
-                            if (strcmp(candidates[c].term, entry->words[j]) == 0) {
-                                found = true;
-                                break;
+    size_t postings_visited = 0;
+    int query_len = (int)strlen(query);
+    int prefix_len = (query_len < dict->prefix_length) ? query_len : dict->prefix_length;
+    query_pattern_t pattern;
+    query_pattern_init(&pattern, dict, query, query_len);
+
+    /* Lookups are serialized by lookup_mutex, so the group stamps and the
+     * prefix cache can live in the dictionary */
+    symspell_dict_t* scratch = (symspell_dict_t*)dict;
+
+    /* Groups to verify, from the prefix cache or the delete table */
+    found_group_t* found = scratch->found_groups;
+    size_t found_count = 0;
+    bool found_complete = true;
+
+    /* explain bypasses the cache so that the trace lists every delete */
+    uint64_t cache_key = 0;
+    prefix_cache_slot_t* cache_slot = NULL;
+    uint32_t* cache_groups = NULL;
+    if (!explain) {
+        cache_key = prefix_cache_key(query, prefix_len, max_edit_distance);
+        size_t slot = cache_key % PREFIX_CACHE_SLOTS;
+        cache_slot = &scratch->prefix_cache[slot];
+        cache_groups = scratch->prefix_cache_groups + slot * PREFIX_CACHE_MAX_GROUPS;
+    }
+
+    if (cache_slot && cache_slot->key == cache_key) {
+        /* Same prefix, same deletes: skip generation and probing and verify
+         * the groups in the order the original search expanded them */
+        SYMSPELL_PROBE3(fuzzy__cached, strlen(query), max_edit_distance, cache_slot->count);
+        for (uint32_t g = 0; g < cache_slot->count; g++) {
+            SYMSPELL_PREFETCH(&dict->groups[cache_groups[g]]);
+            found[g].group = cache_groups[g];
+            found[g].short_distance = -1;
+        }
+        found_count = cache_slot->count;
+    } else {
+        if (cache_slot) cache_slot->key = 0;
+
+        size_t delete_count = _generate_all_deletes_reuse(
+            query, max_edit_distance, dict->prefix_length,
+            dict->delete_work_buffer, dict->delete_buffer_capacity
+        );
+        SYMSPELL_PROBE3(fuzzy__start, strlen(query), max_edit_distance, delete_count);
+        hash_deletes(dict, delete_count);
+
+        /*
+         * The search runs in stages so that the random loads of different
+         * deletes overlap instead of each waiting for the previous one:
+         * prefetch every home slot, then every entry the slots point at,
+         * then compare keys and queue the groups reached, then verify.
+         */
+        for (size_t d = 0; d < delete_count; d++) {
+            size_t home = dict->delete_hashes[d] % dict->table_size;
+            dict->delete_slots[d] = home;
+            if (dict->index_slots) {
+                SYMSPELL_PREFETCH(&dict->index_slots[home]);
+            } else {
+                SYMSPELL_PREFETCH(&dict->table[home]);
+            }
+        }
+        for (size_t d = 0; d < delete_count; d++) {
+            if (dict->index_slots) {
+                uint32_t slot = table_slot(dict, dict->delete_slots[d]);
+                if (slot != INDEX_SLOT_EMPTY) SYMSPELL_PREFETCH(&dict->index_entries[slot - 1]);
+            } else {
+                const delete_entry_t* entry = dict->table[dict->delete_slots[d]];
+                if (entry) SYMSPELL_PREFETCH(entry);
+            }
+        }
+
+        /* Each prefix group is expanded once per query */
+        if (++scratch->lookup_stamp == 0) {
+            if (dict->group_seen) memset(dict->group_seen, 0, dict->group_count * sizeof(uint32_t));
+            scratch->lookup_stamp = 1;
+        }
+        uint32_t stamp = dict->lookup_stamp;
+
+        if (explain) {
+            uint64_t now = clock_ns(CLOCK_MONOTONIC);
+            explain->generate_ns = now - stage_ns;
+            stage_ns = now;
+        }
+
+        for (size_t d = 0; d < delete_count; d++) {
+            if (explain) {
+                explain_add_delete(explain, dict->delete_work_buffer[d],
+                                   prefix_len - (int)strlen(dict->delete_work_buffer[d]));
+            }
+            size_t home = dict->delete_slots[d];
+            int query_depth = prefix_len - (int)dict->delete_lengths[d];
+            for (size_t probe = 0; probe < dict->table_size; probe++) {
+                size_t idx = home + probe < dict->table_size ? home + probe
+                                                             : home + probe - dict->table_size;
+                if (explain) {
+                    explain->table_probes++;
+                    if (!explain->truncated) explain->deletes[explain->delete_count - 1].probes++;
+                }
+                delete_entry_t image_entry;
+                const delete_entry_t* entry = table_entry(dict, idx, &image_entry);
+                if (!entry) {
+                    SYMSPELL_PROBE2(delete__miss, strlen(dict->delete_work_buffer[d]), probe + 1);
+                    break;
+                }
+
+                if (entry_key_equals(entry, &dict->delete_packed[d], dict->delete_lengths[d])) {
+                    const uint32_t* postings = entry_postings(entry);
+                    if (explain) {
+                        explain->posting_hits++;
+                        if (!explain->truncated) {
+                            size_t words = 0;
+                            for (size_t j = 0; j < entry->count; j++) {
+                                uint32_t group_id = postings[j] & POSTING_GROUP_MASK;
+                                if (group_id < dict->group_count) {
+                                    words += dict->groups[group_id].count;
+                                }
                             }
+                            explain->deletes[explain->delete_count - 1].hit = true;
+                            explain->deletes[explain->delete_count - 1].posting_size = words;
                         }
-                        if (!found) {
-                            strncpy(candidates[candidate_count].term, entry->words[j], SYMSPELL_MAX_TERM_LENGTH - 1);
-                            candidates[candidate_count].frequency = entry->frequencies[j];
-                            candidates[candidate_count].distance = dist;
-                            candidate_count++;
+                    }
+                    for (size_t j = 0; j < entry->count; j++) {
+                        uint32_t group_id = postings[j] & POSTING_GROUP_MASK;
+                        int depth = (int)(postings[j] >> POSTING_DEPTH_SHIFT);
+                        /* Each edit costs at most one delete on either side, so a
+                         * group within the budget is also reached by a delete no
+                         * deeper than it */
+                        if (depth > max_edit_distance) continue;
+                        if (group_id >= dict->group_count || dict->group_seen[group_id] == stamp) continue;
+                        if (!group_usable(scratch, group_id)) continue;
+                        if (found_count >= dict->found_capacity) {
+                            found_complete = false;
+                            continue;
                         }
+                        dict->group_seen[group_id] = stamp;
+                        SYMSPELL_PREFETCH(&dict->groups[group_id]);
+                        /* When the query and a word are their own prefixes and one
+                         * side deleted nothing, the other side's deletes are the
+                         * only edits: the distance is the depth sum */
+                        found[found_count].group = group_id;
+                        found[found_count].short_distance =
+                            (query_len <= dict->prefix_length && (query_depth == 0 || depth == 0))
+                            ? query_depth + depth : -1;
+                        found_count++;
                     }
+                    break;
                 }
-                break;
             }
         }
+
+        for (size_t d = 0; d < delete_count; d++) {
+            free(dict->delete_work_buffer[d]);
+            dict->delete_work_buffer[d] = NULL;
+        }
+
     }
-    
-    for (size_t d = 0; d < delete_count; d++) {
-        free(dict->delete_work_buffer[d]);
-        dict->delete_work_buffer[d] = NULL;
+
+    int parallel_count = -1;
+    if (dict->verify_pool && !explain) {
+        parallel_count = verify_parallel(dict, found, found_count, query, query_len, &pattern,
+                                         max_edit_distance, candidates, &postings_visited);
+    }
+    if (parallel_count >= 0) {
+        candidate_count = parallel_count;
+    } else {
+        for (size_t g = 0; g < found_count && candidate_count < MAX_CANDIDATES_PER_LOOKUP; g++) {
+            if (g + VERIFY_PREFETCH_DISTANCE < found_count) {
+                const prefix_group_t* ahead = &dict->groups[found[g + VERIFY_PREFETCH_DISTANCE].group];
+                SYMSPELL_PREFETCH(&dict->word_table[ahead->first]);
+            }
+            candidate_count = verify_group(dict, found[g].group, query, query_len, &pattern,
+                                           max_edit_distance, found[g].short_distance,
+                                           candidates, candidate_count, &postings_visited, explain);
+        }
+    }
+
+    /* The groups reached depend only on the prefix and the distance, and a
+     * hit verifies them in the same order under the same candidate cap, so
+     * any complete group list that fits the slot can be cached */
+    if (cache_slot && cache_slot->key == 0 && found_complete &&
+        found_count <= PREFIX_CACHE_MAX_GROUPS) {
+        for (size_t g = 0; g < found_count; g++) cache_groups[g] = found[g].group;
+        cache_slot->count = (uint32_t)found_count;
+        cache_slot->key = cache_key;
+    }
+    SYMSPELL_PROBE3(fuzzy__done, strlen(query), candidate_count, postings_visited);
+    (void)postings_visited;
+
+    if (explain) {
+        uint64_t now = clock_ns(CLOCK_MONOTONIC);
+        explain->search_ns = now - stage_ns;
+        stage_ns = now;
     }
 
 #ifdef DO_SORT
@@ -768,16 +2589,27 @@ int symspell_lookup(
     for (int i = 0; i < result_count; i++) {
         suggestions[i] = candidates[i];
     }
-    pthread_mutex_unlock((pthread_mutex_t*)&dict->lookup_mutex);
+    if (explain) {
+        explain->rank_ns = clock_ns(CLOCK_MONOTONIC) - stage_ns;
+        if (result_count > 0) {
+            explain_rank(explain, &suggestions[0]);
+        } else {
+            snprintf(explain->reason, sizeof(explain->reason),
+                     "no candidate within distance %d", max_edit_distance);
+        }
+    }
     return result_count;
 #else
+    (void)max_suggestions;
     if (candidate_count > 0) {
         symspell_suggestion_t best_suggestion = candidates[0];
         for (int i = 1; i < candidate_count; i++) {
             if (candidates[i].distance < best_suggestion.distance) {
                 best_suggestion = candidates[i];
             } else if (candidates[i].distance == best_suggestion.distance &&
-                       candidates[i].frequency > best_suggestion.frequency) {
+                       (candidates[i].frequency > best_suggestion.frequency ||
+                        (candidates[i].frequency == best_suggestion.frequency &&
+                         strcmp(candidates[i].term, best_suggestion.term) < 0))) {
                 best_suggestion = candidates[i];
             }
         }
@@ -788,14 +2620,165 @@ int symspell_lookup(
         best_suggestion.iwf = calculate_iwf(probability);
 
         suggestions[0] = best_suggestion;
-        pthread_mutex_unlock((pthread_mutex_t*)&dict->lookup_mutex);
+        if (explain) {
+            explain->rank_ns = clock_ns(CLOCK_MONOTONIC) - stage_ns;
+            explain_rank(explain, &best_suggestion);
+        }
         return 1;
     }
-    pthread_mutex_unlock((pthread_mutex_t*)&dict->lookup_mutex);
+    if (explain) {
+        explain->rank_ns = clock_ns(CLOCK_MONOTONIC) - stage_ns;
+        snprintf(explain->reason, sizeof(explain->reason),
+                 "no candidate within distance %d", max_edit_distance);
+    }
     return 0;
 #endif
 }
 
+/* Lookup suggestions */
+int symspell_lookup(
+    const symspell_dict_t* dict, const char* term, int max_edit_distance_lookup,
+    symspell_suggestion_t* suggestions, int max_suggestions
+) {
+    if (!dict || !term || !suggestions || max_suggestions <= 0) return 0;
+    SYMSPELL_PROBE3(lookup__entry, term, strlen(term), max_edit_distance_lookup);
+
+    /* Read the hook once so the clock reads and the call agree on it.
+     * The clock is only read when someone is listening */
+    symspell_lookup_hook_fn hook = dict->lookup_hook;
+    void* hook_data = dict->lookup_hook_data;
+    uint64_t timestamp_ns = 0;
+    uint64_t start_ns = 0;
+    if (hook) {
+        timestamp_ns = clock_ns(CLOCK_REALTIME);
+        start_ns = clock_ns(CLOCK_MONOTONIC);
+    }
+
+    pthread_mutex_lock((pthread_mutex_t*)&dict->lookup_mutex);
+    int count = lookup_core(dict, term, max_edit_distance_lookup,
+                            suggestions, max_suggestions, NULL);
+    pthread_mutex_unlock((pthread_mutex_t*)&dict->lookup_mutex);
+    SYMSPELL_PROBE3(lookup__return, strlen(term), count,
+                    count > 0 ? suggestions[0].distance : -1);
+
+    if (hook) {
+        uint64_t latency_ns = clock_ns(CLOCK_MONOTONIC) - start_ns;
+        hook(hook_data, term, max_edit_distance_lookup, max_suggestions,
+             suggestions, count, timestamp_ns, latency_ns);
+    }
+    return count;
+}
+
+/* Lookup suggestions and record the work done */
+int symspell_lookup_explain(
+    const symspell_dict_t* dict, const char* term, int max_edit_distance_lookup,
+    symspell_suggestion_t* suggestions, int max_suggestions,
+    symspell_explain_t* explain
+) {
+    if (!explain) {
+        return symspell_lookup(dict, term, max_edit_distance_lookup,
+                               suggestions, max_suggestions);
+    }
+    memset(explain, 0, sizeof(*explain));
+    explain->winner = -1;
+    explain->max_edit_distance = max_edit_distance_lookup;
+    if (!dict || !term || !suggestions || max_suggestions <= 0) return 0;
+
+    symspell_lookup_hook_fn hook = dict->lookup_hook;
+    void* hook_data = dict->lookup_hook_data;
+    uint64_t timestamp_ns = hook ? clock_ns(CLOCK_REALTIME) : 0;
+    uint64_t start_ns = clock_ns(CLOCK_MONOTONIC);
+    pthread_mutex_lock((pthread_mutex_t*)&dict->lookup_mutex);
+    int count = lookup_core(dict, term, max_edit_distance_lookup,
+                            suggestions, max_suggestions, explain);
+    pthread_mutex_unlock((pthread_mutex_t*)&dict->lookup_mutex);
+    explain->total_ns = clock_ns(CLOCK_MONOTONIC) - start_ns;
+
+    if (hook) {
+        hook(hook_data, term, max_edit_distance_lookup, max_suggestions,
+             suggestions, count, timestamp_ns, explain->total_ns);
+    }
+    return count;
+}
+
+/* Print an explain trace */
+void symspell_explain_print(const symspell_explain_t* explain, FILE* out) {
+    if (!explain || !out) return;
+
+    fprintf(out, "query '%s' (max distance %d)\n", explain->query, explain->max_edit_distance);
+    fprintf(out, "  exact table: %s after %d probe(s)\n",
+            explain->exact_hit ? "hit" : "miss", explain->exact_probes);
+
+    if (!explain->exact_hit) {
+        fprintf(out, "  deletes: %zu generated, %zu hit, %zu slots probed\n",
+                explain->delete_count, explain->posting_hits, explain->table_probes);
+        for (size_t i = 0; i < explain->delete_count; i++) {
+            const symspell_explain_delete_t* d = &explain->deletes[i];
+            fprintf(out, "    [%zu] '%s' depth %d, %d probe(s), %s",
+                    i, d->delete_str, d->depth, d->probes, d->hit ? "hit" : "miss");
+            if (d->hit) fprintf(out, ", %zu posting(s)", d->posting_size);
+            fprintf(out, "\n");
+        }
+        fprintf(out, "  candidates: %zu verified, %zu accepted\n",
+                explain->postings_visited, explain->accepted);
+        for (size_t i = 0; i < explain->candidate_count; i++) {
+            const symspell_explain_candidate_t* c = &explain->candidates[i];
+            const char* verdict = c->accepted ? "accepted" : "rejected";
+            fprintf(out, "    %s%-20s distance %d, freq %llu, via [%zu], %s\n",
+                    (long)i == explain->winner ? "* " : "  ", c->term,
+                    c->distance, (unsigned long long)c->frequency,
+                    c->delete_index, verdict);
+        }
+    }
+
+    fprintf(out, "  time: normalize %.2f µs, exact %.2f µs, generate %.2f µs, "
+                 "search %.2f µs (verify %.2f µs), rank %.2f µs, total %.2f µs\n",
+            explain->normalize_ns / 1000.0, explain->exact_ns / 1000.0,
+            explain->generate_ns / 1000.0, explain->search_ns / 1000.0,
+            explain->verify_ns / 1000.0, explain->rank_ns / 1000.0,
+            explain->total_ns / 1000.0);
+    fprintf(out, "  result: %s\n", explain->reason);
+    if (explain->truncated) fprintf(out, "  (trace truncated: out of memory)\n");
+}
+
+/* Release explain trace arrays */
+void symspell_explain_free(symspell_explain_t* explain) {
+    if (!explain) return;
+    free(explain->deletes);
+    free(explain->candidates);
+    explain->deletes = NULL;
+    explain->candidates = NULL;
+    explain->delete_count = 0;
+    explain->candidate_count = 0;
+}
+
+/* Install or remove the lookup hook */
+void symspell_set_lookup_hook(
+    symspell_dict_t* dict, symspell_lookup_hook_fn hook, void* user_data
+) {
+    if (!dict) return;
+    dict->lookup_hook = hook;
+    dict->lookup_hook_data = user_data;
+}
+
+/* Start, replace or (threads == 0) stop the verification helpers */
+bool symspell_set_verify_threads(symspell_dict_t* dict, int threads, size_t min_words) {
+    if (!dict || threads < 0 || threads > SYMSPELL_MAX_VERIFY_THREADS) return false;
+    verify_pool_t* pool = NULL;
+    if (threads > 0) {
+        pool = verify_pool_create((size_t)threads, min_words);
+        if (!pool) perror("symspell_set_verify_threads failed");
+    }
+
+    /* Lookups use the pool under lookup_mutex; join the old one outside it */
+    pthread_mutex_lock(&dict->lookup_mutex);
+    verify_pool_t* old = dict->verify_pool;
+    dict->verify_pool = pool;
+    pthread_mutex_unlock(&dict->lookup_mutex);
+    verify_pool_destroy(old);
+    return threads == 0 || pool != NULL;
+}
+
 /* Get probability for a word hash */
 float symspell_get_probability(const symspell_dict_t* dict, uint64_t word_hash) {
     if (!dict || !dict->exact_table) return 0.0f;
@@ -844,10 +2827,14 @@ void symspell_destroy(symspell_dict_t* dict) {
     if (!dict) return;
     
     if (dict->exact_table) {
-        free(dict->exact_table->hashes);
-        free(dict->exact_table->frequencies);
-        free(dict->exact_table->probabilities);
-        free(dict->exact_table->iwf);
+        /* Arrays of an index-backed dictionary live in the image */
+        if (!dict->index_image) {
+            free(dict->exact_table->hashes);
+            free(dict->exact_table->frequencies);
+            free(dict->exact_table->probabilities);
+            free(dict->exact_table->iwf);
+        }
+        free(dict->exact_table->word_ids);
         free(dict->exact_table);
     }
     
@@ -857,14 +2844,17 @@ void symspell_destroy(symspell_dict_t* dict) {
         }
         free(dict->delete_work_buffer);
     }
+    free(dict->delete_lengths);
+    free(dict->delete_hashes);
+    free(dict->delete_packed);
+    free(dict->delete_slots);
     free(dict->candidate_buffer);
+    verify_pool_destroy(dict->verify_pool);
     
     if (dict->table) {
-        for (size_t i = 0; i < dict->table_size; i++) {
-            if (dict->table[i]) {
-                delete_entry_t* entry = dict->table[i];
-                free(entry->words); 
-                free(entry->frequencies);
+        for (size_t i = 0; i < dict->table_size && !dict->index_image; i++) {
+            if (dict->table[i] && dict->table[i]->count > ENTRY_INLINE_POSTINGS) {
+                free(dict->table[i]->postings.groups);
             }
         }
         free(dict->table);
@@ -872,6 +2862,23 @@ void symspell_destroy(symspell_dict_t* dict) {
 
     free(dict->string_arena.memory);
     free(dict->entry_arena.memory);
+    if (!dict->index_image) {
+        free(dict->word_table);
+        free(dict->groups);
+    }
+    free(dict->group_seen);
+    free(dict->found_groups);
+    free(dict->prefix_cache);
+    free(dict->prefix_cache_groups);
+
+    free(dict->group_checked);
+    if (dict->index_image) {
+        if (dict->index_mapped) {
+            munmap(dict->index_image, dict->index_image_size);
+        } else {
+            free(dict->index_image);
+        }
+    }
     
     pthread_mutex_destroy(&dict->lookup_mutex);
     free(dict);
@@ -886,3 +2893,131 @@ void symspell_get_stats(
         if (entry_count) *entry_count = dict->entry_count;
     }
 }
+
+/* Distinct cache lines covered by k consecutive slots starting at start */
+static size_t probe_cache_lines(size_t start, size_t k, size_t slots, size_t slot_bytes) {
+    size_t lines = 0;
+    while (k > 0) {
+        size_t run = (start + k <= slots) ? k : slots - start;
+        size_t first = start * slot_bytes / CACHE_LINE_SIZE;
+        size_t last = ((start + run) * slot_bytes - 1) / CACHE_LINE_SIZE;
+        lines += last - first + 1;
+        k -= run;
+        start = 0;
+    }
+    return lines;
+}
+
+static void histogram_add(uint64_t* histogram, size_t probes) {
+    size_t bucket = probes - 1;
+    if (bucket >= SYMSPELL_PROBE_HISTOGRAM_SIZE) bucket = SYMSPELL_PROBE_HISTOGRAM_SIZE - 1;
+    histogram[bucket]++;
+}
+
+/*
+ * Probe statistics for a linear-probing table described by the home slot of
+ * every occupied slot (SLOT_EMPTY for empty ones).
+ */
+static void compute_probe_stats(const uint32_t* home, size_t slots, size_t slot_bytes,
+                                size_t compare_loads, symspell_table_stats_t* stats) {
+    memset(stats, 0, sizeof(*stats));
+    stats->slots = slots;
+
+    size_t first_empty = slots;
+    for (size_t i = 0; i < slots; i++) {
+        if (home[i] == SLOT_EMPTY) {
+            if (first_empty == slots) first_empty = i;
+        } else {
+            stats->occupied++;
+        }
+    }
+    stats->load_factor = slots ? (double)stats->occupied / (double)slots : 0.0;
+    if (first_empty == slots) return; /* full table: every miss probes forever */
+
+    /* Successful searches: displacement from the home slot */
+    double hit_total = 0, hit_misses = 0;
+    for (size_t i = 0; i < slots; i++) {
+        if (home[i] == SLOT_EMPTY) continue;
+        size_t probes = ((i + slots - home[i]) % slots) + 1;
+        histogram_add(stats->hit_probes, probes);
+        if (probes > stats->max_hit_probes) stats->max_hit_probes = probes;
+        hit_total += (double)probes;
+        hit_misses += (double)(probe_cache_lines(home[i], probes, slots, slot_bytes) +
+                               probes * compare_loads);
+    }
+
+    /*
+     * Unsuccessful searches and clusters: walk backwards from an empty slot
+     * so the run length of occupied slots ahead of each slot is known.
+     */
+    double miss_total = 0, miss_misses = 0;
+    size_t run = 0;
+    for (size_t n = 0; n < slots; n++) {
+        size_t i = (first_empty + slots - n) % slots;
+        if (home[i] == SLOT_EMPTY) {
+            if (run > 0) {
+                stats->clusters++;
+                if (run > stats->longest_cluster) stats->longest_cluster = run;
+            }
+            run = 0;
+        } else {
+            run++;
+        }
+        size_t probes = run + 1;
+        histogram_add(stats->miss_probes, probes);
+        if (probes > stats->max_miss_probes) stats->max_miss_probes = probes;
+        miss_total += (double)probes;
+        miss_misses += (double)(probe_cache_lines(i, probes, slots, slot_bytes) +
+                                run * compare_loads);
+    }
+    if (run > 0) {
+        stats->clusters++;
+        if (run > stats->longest_cluster) stats->longest_cluster = run;
+    }
+
+    if (stats->occupied) {
+        stats->mean_hit_probes = hit_total / (double)stats->occupied;
+        stats->expected_hit_misses = hit_misses / (double)stats->occupied;
+    }
+    stats->mean_miss_probes = miss_total / (double)slots;
+    stats->expected_miss_misses = miss_misses / (double)slots;
+    if (stats->clusters) {
+        stats->mean_cluster = (double)stats->occupied / (double)stats->clusters;
+    }
+}
+
+/* Get hash table diagnostics */
+bool symspell_get_table_stats(
+    const symspell_dict_t* dict, symspell_table_t table, symspell_table_stats_t* stats
+) {
+    if (!dict || !stats) return false;
+
+    size_t slots = (table == SYMSPELL_TABLE_EXACT) ? dict->exact_table->table_size
+                                                   : dict->table_size;
+    uint32_t* home = malloc(slots * sizeof(uint32_t));
+    if (!home) {
+        perror("symspell_get_table_stats failed: malloc home");
+        return false;
+    }
+
+    if (table == SYMSPELL_TABLE_EXACT) {
+        for (size_t i = 0; i < slots; i++) {
+            uint64_t hash = dict->exact_table->hashes[i];
+            home[i] = hash ? (uint32_t)(hash % slots) : SLOT_EMPTY;
+        }
+        compute_probe_stats(home, slots, sizeof(uint64_t), EXACT_COMPARE_LOADS, stats);
+    } else {
+        for (size_t i = 0; i < slots; i++) {
+            delete_entry_t scratch;
+            const delete_entry_t* entry = table_entry(dict, i, &scratch);
+            home[i] = entry ? (uint32_t)(xxh3(entry_key(entry), entry->key_length) % slots)
+                            : SLOT_EMPTY;
+        }
+        compute_probe_stats(home, slots,
+                            dict->index_slots ? sizeof(uint32_t) : sizeof(delete_entry_t*),
+                            DELETE_COMPARE_LOADS, stats);
+    }
+
+    free(home);
+    return true;
+}
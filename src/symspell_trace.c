@@ -0,0 +1,266 @@
+/*
+ * symspell_trace.c - Query trace capture and decoding
+ *
+ * Writes and reads the binary trace format described in symspell_trace.h.
+ * Records are varint encoded so a typical lookup costs 20-30 bytes on disk.
+ * The writer serializes appends with its own mutex, so one writer can be
+ * shared by every thread that calls symspell_lookup().
+ *
+ * Copyright (c) 2025 CGIOS Project
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <pthread.h>
+#include "symspell_trace.h"
+
+/* --- Constants --- */
+#define TRACE_MAGIC "SSTRACE1"
+#define TRACE_MAGIC_LENGTH 8
+#define TRACE_MAX_TERM_LENGTH 127
+#define TRACE_RECORD_BUFFER 2048
+#define TRACE_STREAM_BUFFER (256 * 1024)
+#define VARINT_MAX_BYTES 10
+
+struct symspell_trace_writer {
+    FILE* fp;
+    pthread_mutex_t mutex;
+    uint64_t last_timestamp_ns;
+    uint64_t records;
+    char* stream_buffer;
+};
+
+struct symspell_trace_reader {
+    FILE* fp;
+    uint64_t last_timestamp_ns;
+};
+
+/* --- Varint Encoding --- */
+
+static size_t put_varint(uint8_t* out, uint64_t value) {
+    size_t n = 0;
+    while (value >= 0x80) {
+        out[n++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    out[n++] = (uint8_t)value;
+    return n;
+}
+
+/* Map signed deltas onto small unsigned values: 0,-1,1,-2 -> 0,1,2,3 */
+static uint64_t zigzag_encode(int64_t value) {
+    return ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);
+}
+
+static int64_t zigzag_decode(uint64_t value) {
+    return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+}
+
+static size_t put_string(uint8_t* out, const char* s) {
+    size_t len = strlen(s);
+    if (len > TRACE_MAX_TERM_LENGTH) len = TRACE_MAX_TERM_LENGTH;
+    size_t n = put_varint(out, len);
+    memcpy(out + n, s, len);
+    return n + len;
+}
+
+static bool get_varint(FILE* fp, uint64_t* value) {
+    uint64_t result = 0;
+    for (int shift = 0; shift < 7 * VARINT_MAX_BYTES; shift += 7) {
+        int c = fgetc(fp);
+        if (c == EOF) return false;
+        result |= (uint64_t)(c & 0x7f) << shift;
+        if (!(c & 0x80)) {
+            *value = result;
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool get_string(FILE* fp, char* out) {
+    uint64_t len;
+    if (!get_varint(fp, &len) || len > TRACE_MAX_TERM_LENGTH) return false;
+    if (len > 0 && fread(out, 1, (size_t)len, fp) != len) return false;
+    out[len] = '\0';
+    return true;
+}
+
+/* --- Writer --- */
+
+symspell_trace_writer_t* symspell_trace_writer_open(const char* filepath) {
+    if (!filepath) return NULL;
+
+    symspell_trace_writer_t* writer = calloc(1, sizeof(symspell_trace_writer_t));
+    if (!writer) {
+        perror("symspell_trace_writer_open failed: calloc writer");
+        return NULL;
+    }
+
+    writer->fp = fopen(filepath, "wb");
+    if (!writer->fp) {
+        perror("symspell_trace_writer_open failed: fopen");
+        free(writer);
+        return NULL;
+    }
+
+    /* Large stdio buffer so the hook rarely touches the disk */
+    writer->stream_buffer = malloc(TRACE_STREAM_BUFFER);
+    if (writer->stream_buffer) {
+        setvbuf(writer->fp, writer->stream_buffer, _IOFBF, TRACE_STREAM_BUFFER);
+    }
+
+    if (pthread_mutex_init(&writer->mutex, NULL) != 0 ||
+        fwrite(TRACE_MAGIC, 1, TRACE_MAGIC_LENGTH, writer->fp) != TRACE_MAGIC_LENGTH) {
+        perror("symspell_trace_writer_open failed");
+        fclose(writer->fp);
+        free(writer->stream_buffer);
+        free(writer);
+        return NULL;
+    }
+    return writer;
+}
+
+bool symspell_trace_write(
+    symspell_trace_writer_t* writer, const symspell_trace_record_t* record
+) {
+    if (!writer || !record) return false;
+
+    uint8_t buf[TRACE_RECORD_BUFFER];
+    int stored = record->stored_count;
+    if (stored > SYMSPELL_TRACE_MAX_RESULTS) stored = SYMSPELL_TRACE_MAX_RESULTS;
+    if (stored < 0) stored = 0;
+
+    /* Encode everything except the timestamp outside the lock */
+    size_t n = 0;
+    n += put_varint(buf + n, record->latency_ns);
+    n += put_varint(buf + n, (uint64_t)record->max_edit_distance);
+    n += put_varint(buf + n, (uint64_t)record->max_suggestions);
+    n += put_string(buf + n, record->term);
+    n += put_varint(buf + n, (uint64_t)record->result_count);
+    n += put_varint(buf + n, (uint64_t)stored);
+    for (int i = 0; i < stored; i++) {
+        n += put_string(buf + n, record->results[i].term);
+        n += put_varint(buf + n, (uint64_t)record->results[i].distance);
+        n += put_varint(buf + n, record->results[i].frequency);
+    }
+
+    uint8_t ts[VARINT_MAX_BYTES];
+    pthread_mutex_lock(&writer->mutex);
+    int64_t delta = (int64_t)(record->timestamp_ns - writer->last_timestamp_ns);
+    size_t ts_len = put_varint(ts, zigzag_encode(delta));
+    bool ok = fwrite(ts, 1, ts_len, writer->fp) == ts_len &&
+              fwrite(buf, 1, n, writer->fp) == n;
+    if (ok) {
+        writer->last_timestamp_ns = record->timestamp_ns;
+        writer->records++;
+    }
+    pthread_mutex_unlock(&writer->mutex);
+    return ok;
+}
+
+void symspell_trace_hook(
+    void* user_data, const char* term, int max_edit_distance, int max_suggestions,
+    const symspell_suggestion_t* suggestions, int count,
+    uint64_t timestamp_ns, uint64_t latency_ns
+) {
+    symspell_trace_record_t record;
+    record.timestamp_ns = timestamp_ns;
+    record.latency_ns = latency_ns;
+    record.max_edit_distance = max_edit_distance;
+    record.max_suggestions = max_suggestions;
+    snprintf(record.term, sizeof(record.term), "%s", term);
+    record.result_count = count;
+    record.stored_count = (count < SYMSPELL_TRACE_MAX_RESULTS) ? count : SYMSPELL_TRACE_MAX_RESULTS;
+    for (int i = 0; i < record.stored_count; i++) {
+        record.results[i] = suggestions[i];
+    }
+    symspell_trace_write((symspell_trace_writer_t*)user_data, &record);
+}
+
+uint64_t symspell_trace_writer_close(symspell_trace_writer_t* writer) {
+    if (!writer) return 0;
+    uint64_t records = writer->records;
+    if (fclose(writer->fp) != 0) {
+        perror("symspell_trace_writer_close failed: fclose");
+    }
+    pthread_mutex_destroy(&writer->mutex);
+    free(writer->stream_buffer);
+    free(writer);
+    return records;
+}
+
+/* --- Reader --- */
+
+symspell_trace_reader_t* symspell_trace_reader_open(const char* filepath) {
+    if (!filepath) return NULL;
+
+    FILE* fp = fopen(filepath, "rb");
+    if (!fp) return NULL;
+
+    char magic[TRACE_MAGIC_LENGTH];
+    if (fread(magic, 1, TRACE_MAGIC_LENGTH, fp) != TRACE_MAGIC_LENGTH ||
+        memcmp(magic, TRACE_MAGIC, TRACE_MAGIC_LENGTH) != 0) {
+        fprintf(stderr, "Error: %s is not a symspell trace\n", filepath);
+        fclose(fp);
+        return NULL;
+    }
+
+    symspell_trace_reader_t* reader = calloc(1, sizeof(symspell_trace_reader_t));
+    if (!reader) {
+        fclose(fp);
+        return NULL;
+    }
+    reader->fp = fp;
+    return reader;
+}
+
+bool symspell_trace_read(
+    symspell_trace_reader_t* reader, symspell_trace_record_t* record
+) {
+    if (!reader || !record) return false;
+
+    uint64_t delta, latency, max_ed, max_sugg, result_count, stored;
+    if (!get_varint(reader->fp, &delta)) return false;
+    if (!get_varint(reader->fp, &latency) ||
+        !get_varint(reader->fp, &max_ed) ||
+        !get_varint(reader->fp, &max_sugg) ||
+        !get_string(reader->fp, record->term) ||
+        !get_varint(reader->fp, &result_count) ||
+        !get_varint(reader->fp, &stored) ||
+        stored > SYMSPELL_TRACE_MAX_RESULTS) {
+        fprintf(stderr, "Warning: truncated or corrupt trace record\n");
+        return false;
+    }
+
+    reader->last_timestamp_ns += (uint64_t)zigzag_decode(delta);
+    record->timestamp_ns = reader->last_timestamp_ns;
+    record->latency_ns = latency;
+    record->max_edit_distance = (int)max_ed;
+    record->max_suggestions = (int)max_sugg;
+    record->result_count = (int)result_count;
+    record->stored_count = (int)stored;
+
+    for (int i = 0; i < record->stored_count; i++) {
+        uint64_t distance, frequency;
+        if (!get_string(reader->fp, record->results[i].term) ||
+            !get_varint(reader->fp, &distance) ||
+            !get_varint(reader->fp, &frequency)) {
+            fprintf(stderr, "Warning: truncated or corrupt trace record\n");
+            return false;
+        }
+        record->results[i].distance = (int)distance;
+        record->results[i].frequency = frequency;
+        record->results[i].probability = 0.0f;
+        record->results[i].iwf = 0.0f;
+    }
+    return true;
+}
+
+void symspell_trace_reader_close(symspell_trace_reader_t* reader) {
+    if (!reader) return;
+    fclose(reader->fp);
+    free(reader);
+}
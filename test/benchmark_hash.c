@@ -0,0 +1,440 @@
+/*
+ * benchmark_hash.c - Throughput of the hash.h tables.
+ *
+ * Reads the words of a dictionary as keys and times, over several rounds:
+ *
+ *   insert     every key into a table grown from the default size
+ *   find-hit   every key, in shuffled order
+ *   find-miss  every key with a suffix appended (absent from the table)
+ *   delete     every key, in shuffled order, until the table is empty
+ *   churn      delete and re-insert half the keys in a full table
+ *
+ * Each round runs once on an HT_TABLE keyed by the words themselves and once on an
+ * HT_DEFINE table keyed by their xxh3 hashes (identity-hashed, values
+ * inline). The best round of each phase is reported in ns/op, after the
+ * probe statistics of the full HT_TABLE. Build the same file against two
+ * versions of hash.h to compare them.
+ *
+ * Finally xxh3 is timed per hash on the dictionary words and on random keys
+ * of each short length class, through the portable path, the runtime
+ * short-key path and xxh3_64bits_batch(). The faster paths are checked for
+ * identical results on every length up to 256 bytes at every alignment.
+ */
+
+#define _GNU_SOURCE
+#define _POSIX_C_SOURCE 200809L
+
+#include "xxh3.h"
+#include "hash.h"
+#include "posix.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define MAX_LINE_BUFFER 8192
+#define DEFAULT_DICTIONARY "dictionaries/dictionary.txt"
+#define DEFAULT_ROUNDS 5
+#define MISS_SUFFIX "#"
+
+typedef enum {
+    PHASE_INSERT,
+    PHASE_FIND_HIT,
+    PHASE_FIND_MISS,
+    PHASE_DELETE,
+    PHASE_CHURN,
+    PHASE_COUNT
+} phase_t;
+
+/* Word hash -> word index, the shape of the maps the engine needs */
+HT_DEFINE(word_map, uint64_t, uint32_t, ht_hash_identity_u64, ht_eq_u64)
+
+static const char* const PHASE_NAMES[PHASE_COUNT] = {
+    "insert", "find-hit", "find-miss", "delete", "churn"
+};
+
+typedef struct {
+    char** items;
+    size_t count;
+    size_t capacity;
+} key_list_t;
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/* xorshift64*: deterministic across platforms, unlike rand() */
+static uint64_t next_random(uint64_t* state) {
+    uint64_t x = *state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    *state = x;
+    return x * 0x2545F4914F6CDD1DULL;
+}
+
+static int keys_add(key_list_t* keys, const char* key) {
+    if (keys->count == keys->capacity) {
+        size_t new_cap = keys->capacity ? keys->capacity * 2 : 1024;
+        char** grown = realloc(keys->items, new_cap * sizeof(char*));
+        if (!grown) return 0;
+        keys->items = grown;
+        keys->capacity = new_cap;
+    }
+    keys->items[keys->count] = strdup(key);
+    return keys->items[keys->count++] != NULL;
+}
+
+static void keys_free(key_list_t* keys) {
+    for (size_t i = 0; i < keys->count; i++) free(keys->items[i]);
+    free(keys->items);
+}
+
+static void shuffle(size_t* items, size_t count, uint64_t* rng) {
+    for (size_t i = count; i > 1; i--) {
+        size_t j = next_random(rng) % i;
+        size_t t = items[i - 1];
+        items[i - 1] = items[j];
+        items[j] = t;
+    }
+}
+
+/* Unique dictionary words (first column) */
+static int load_keys(const char* path, key_list_t* keys) {
+    FILE* fp = fopen(path, "r");
+    if (!fp) {
+        fprintf(stderr, "Failed to open dictionary: %s\n", path);
+        return 0;
+    }
+    HT_TABLE* seen = ht_create(0);
+    c_reader_t* reader = c_reader_open(fp);
+    char* line;
+    int ok = seen != NULL && reader != NULL;
+    while (ok && (line = c_reader_next_line(reader, NULL))) {
+        char* save = NULL;
+        char* word = strtok_r(line, " \t", &save);
+        if (!word) continue;
+        HT_ENTRY find = {word, NULL};
+        if (ht_search(seen, find, HT_FIND)) continue;
+        ok = keys_add(keys, word);
+        if (ok) {
+            HT_ENTRY item = {keys->items[keys->count - 1], NULL};
+            ok = ht_search(seen, item, HT_ENTER) != NULL;
+        }
+    }
+    ok = ok && !c_reader_error(reader);
+    c_reader_close(reader);
+    ht_destroy(seen);
+    fclose(fp);
+    return ok;
+}
+
+static void print_stats(const HT_TABLE* table) {
+    HT_STATS st;
+    ht_stats(table, &st);
+    printf("\nFull table: %zu keys in %zu buckets (load %.1f%%, %zu-byte buckets)\n",
+           st.count, st.size, 100.0 * st.load_factor, sizeof(HT_BUCKET));
+    printf("  Probes (hit):  mean %.3f, max %zu\n", st.mean_hit_probes, st.max_hit_probes);
+    printf("  Probes (miss): mean %.3f, max %zu\n", st.mean_miss_probes, st.max_miss_probes);
+}
+
+/* One round on the char* table; elapsed[] gets the time of each phase */
+static size_t run_string_round(const key_list_t* keys, const key_list_t* misses, size_t* order,
+                               uint64_t* rng, uint64_t elapsed[PHASE_COUNT], int report) {
+    size_t n = keys->count, errors = 0;
+    HT_TABLE* table = ht_create(0);
+    if (!table) return n;
+
+    uint64_t start = now_ns();
+    for (size_t i = 0; i < n; i++) {
+        HT_ENTRY item = {keys->items[i], keys->items[i]};
+        if (!ht_search(table, item, HT_ENTER)) errors++;
+    }
+    elapsed[PHASE_INSERT] = now_ns() - start;
+
+    shuffle(order, n, rng);
+    start = now_ns();
+    for (size_t i = 0; i < n; i++) {
+        HT_ENTRY find = {keys->items[order[i]], NULL};
+        HT_ENTRY* e = ht_search(table, find, HT_FIND);
+        if (!e || e->data != keys->items[order[i]]) errors++;
+    }
+    elapsed[PHASE_FIND_HIT] = now_ns() - start;
+
+    start = now_ns();
+    for (size_t i = 0; i < n; i++) {
+        HT_ENTRY find = {misses->items[i], NULL};
+        if (ht_search(table, find, HT_FIND)) errors++;
+    }
+    elapsed[PHASE_FIND_MISS] = now_ns() - start;
+
+    /* Half deletes, half re-inserts: n operations in a full table */
+    shuffle(order, n, rng);
+    start = now_ns();
+    for (size_t i = 0; i < n / 2; i++) {
+        if (!ht_delete(table, keys->items[order[i]])) errors++;
+    }
+    for (size_t i = 0; i < n / 2; i++) {
+        HT_ENTRY item = {keys->items[order[i]], keys->items[order[i]]};
+        if (!ht_search(table, item, HT_ENTER)) errors++;
+    }
+    elapsed[PHASE_CHURN] = now_ns() - start;
+    if (ht_count(table) != n) errors++;
+    if (report) print_stats(table);
+
+    shuffle(order, n, rng);
+    start = now_ns();
+    for (size_t i = 0; i < n; i++) {
+        if (!ht_delete(table, keys->items[order[i]])) errors++;
+    }
+    elapsed[PHASE_DELETE] = now_ns() - start;
+    if (ht_count(table) != 0) errors++;
+
+    ht_destroy(table);
+    return errors;
+}
+
+/* The same round on a typed table keyed by the xxh3 of each word */
+static size_t run_typed_round(const uint64_t* hashes, const uint64_t* miss_hashes, size_t n,
+                              size_t* order, uint64_t* rng, uint64_t elapsed[PHASE_COUNT]) {
+    size_t errors = 0;
+    word_map_t map;
+    if (!word_map_init(&map, 0)) return n;
+
+    uint64_t start = now_ns();
+    for (size_t i = 0; i < n; i++) {
+        if (!word_map_put(&map, hashes[i], (uint32_t)i)) errors++;
+    }
+    elapsed[PHASE_INSERT] = now_ns() - start;
+
+    shuffle(order, n, rng);
+    start = now_ns();
+    for (size_t i = 0; i < n; i++) {
+        uint32_t* id = word_map_get(&map, hashes[order[i]]);
+        if (!id || *id != order[i]) errors++;
+    }
+    elapsed[PHASE_FIND_HIT] = now_ns() - start;
+
+    start = now_ns();
+    for (size_t i = 0; i < n; i++) {
+        if (word_map_get(&map, miss_hashes[i])) errors++;
+    }
+    elapsed[PHASE_FIND_MISS] = now_ns() - start;
+
+    shuffle(order, n, rng);
+    start = now_ns();
+    for (size_t i = 0; i < n / 2; i++) {
+        if (!word_map_remove(&map, hashes[order[i]])) errors++;
+    }
+    for (size_t i = 0; i < n / 2; i++) {
+        if (!word_map_put(&map, hashes[order[i]], (uint32_t)order[i])) errors++;
+    }
+    elapsed[PHASE_CHURN] = now_ns() - start;
+    if (word_map_count(&map) != n) errors++;
+
+    /* Iteration must visit every key exactly once */
+    size_t pos = 0, visited = 0;
+    uint64_t key;
+    uint32_t* id;
+    while (word_map_next(&map, &pos, &key, &id)) {
+        if (hashes[*id] != key) errors++;
+        visited++;
+    }
+    if (visited != n) errors++;
+
+    shuffle(order, n, rng);
+    start = now_ns();
+    for (size_t i = 0; i < n; i++) {
+        if (!word_map_remove(&map, hashes[order[i]])) errors++;
+    }
+    elapsed[PHASE_DELETE] = now_ns() - start;
+    if (word_map_count(&map) != 0) errors++;
+
+    word_map_free(&map);
+    return errors;
+}
+
+/* The short-key and batched xxh3 paths must reproduce the portable one bit for bit */
+static size_t check_xxh3(uint64_t* rng) {
+    uint8_t buf[256 + 8];
+    size_t mismatches = 0;
+    for (size_t len = 0; len <= 256; len++) {
+        for (int trial = 0; trial < 200; trial++) {
+            size_t offset = next_random(rng) % 8;
+            for (size_t i = 0; i < len; i++) buf[offset + i] = (uint8_t)next_random(rng);
+            if (xxh3_64bits(buf + offset, len) != xxh3_XXH3_64bits_const(buf + offset, len)) {
+                mismatches++;
+            }
+        }
+    }
+
+    /* Mixed lengths, so every block has partial groups of each class */
+    enum { BATCH_KEYS = 10007 };
+    static uint8_t data[BATCH_KEYS * 40];
+    static xxh3_key_t batch[BATCH_KEYS];
+    static uint64_t hashes[BATCH_KEYS];
+    for (size_t i = 0; i < sizeof(data); i++) data[i] = (uint8_t)next_random(rng);
+    for (size_t i = 0; i < BATCH_KEYS; i++) {
+        batch[i].ptr = data + i * 40 + next_random(rng) % 8;
+        batch[i].len = next_random(rng) % 33;
+    }
+    xxh3_64bits_batch(batch, BATCH_KEYS, hashes);
+    for (size_t i = 0; i < BATCH_KEYS; i++) {
+        if (hashes[i] != xxh3_XXH3_64bits_const(batch[i].ptr, batch[i].len)) mismatches++;
+    }
+    return mismatches;
+}
+
+typedef enum { HASH_PORTABLE, HASH_RUNTIME, HASH_BATCH, HASH_PATH_COUNT } hash_path_t;
+
+/* ns per hash over the keys, one key at a time on either path and batched */
+static void time_xxh3(const char* label, char* const* keys, const size_t* lengths, size_t count,
+                      int rounds) {
+    uint64_t best[HASH_PATH_COUNT] = { UINT64_MAX, UINT64_MAX, UINT64_MAX };
+    xxh3_key_t* batch = malloc(count * sizeof(xxh3_key_t));
+    uint64_t* hashes = malloc(count * sizeof(uint64_t));
+    if (!batch || !hashes) {
+        free(batch);
+        free(hashes);
+        return;
+    }
+    for (size_t i = 0; i < count; i++) {
+        batch[i].ptr = keys[i];
+        batch[i].len = lengths[i];
+    }
+
+    volatile uint64_t sink = 0;
+    for (int r = 0; r < rounds; r++) {
+        uint64_t acc = 0;
+        /* Rotate which path runs first, so none always gets a warm cache */
+        for (int k = 0; k < HASH_PATH_COUNT; k++) {
+            hash_path_t path = (hash_path_t)((k + r) % HASH_PATH_COUNT);
+            uint64_t start = now_ns();
+            if (path == HASH_PORTABLE) {
+                for (size_t i = 0; i < count; i++) hashes[i] = xxh3_XXH3_64bits_const(keys[i], lengths[i]);
+            } else if (path == HASH_RUNTIME) {
+                for (size_t i = 0; i < count; i++) hashes[i] = xxh3_64bits(keys[i], lengths[i]);
+            } else {
+                xxh3_64bits_batch(batch, count, hashes);
+            }
+            uint64_t elapsed = now_ns() - start;
+            if (elapsed < best[path]) best[path] = elapsed;
+            acc ^= hashes[r % count];
+        }
+        sink ^= acc;
+    }
+    (void)sink;
+    printf("%-12s %10.2f %10.2f %10.2f %8.2fx\n", label,
+           (double)best[HASH_PORTABLE] / (double)count, (double)best[HASH_RUNTIME] / (double)count,
+           (double)best[HASH_BATCH] / (double)count,
+           (double)best[HASH_PORTABLE] / (double)best[HASH_BATCH]);
+    free(batch);
+    free(hashes);
+}
+
+static void bench_xxh3(const key_list_t* keys, uint64_t* rng, int rounds) {
+    static const struct { const char* label; size_t min, max; } classes[] = {
+        { "1-3 bytes", 1, 3 }, { "4-8 bytes", 4, 8 }, { "9-16 bytes", 9, 16 },
+        { "17-32 bytes", 17, 32 },
+    };
+    size_t n = keys->count;
+    size_t* lengths = malloc(n * sizeof(size_t));
+    key_list_t generated = {0};
+    if (!lengths) return;
+
+    printf("\nxxh3 ns/hash     portable    runtime    batched  speedup%s\n",
+           xxh3_batch_simd_available() ? "" : "  (no AVX2: batch is scalar)");
+    for (size_t i = 0; i < n; i++) lengths[i] = strlen(keys->items[i]);
+    time_xxh3("dictionary", keys->items, lengths, n, rounds);
+
+    char buf[64];
+    for (size_t c = 0; c < sizeof(classes) / sizeof(classes[0]); c++) {
+        for (size_t i = 0; i < n; i++) {
+            size_t len = classes[c].min + next_random(rng) % (classes[c].max - classes[c].min + 1);
+            for (size_t k = 0; k < len; k++) buf[k] = (char)('a' + next_random(rng) % 26);
+            buf[len] = '\0';
+            if (!keys_add(&generated, buf)) break;
+            lengths[i] = len;
+        }
+        if (generated.count == n) time_xxh3(classes[c].label, generated.items, lengths, n, rounds);
+        keys_free(&generated);
+        memset(&generated, 0, sizeof(generated));
+    }
+    free(lengths);
+}
+
+int main(int argc, char* argv[]) {
+    const char* dict_path = DEFAULT_DICTIONARY;
+    int rounds = DEFAULT_ROUNDS;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--rounds") == 0 && i + 1 < argc) {
+            rounds = atoi(argv[++i]);
+        } else if (argv[i][0] != '-') {
+            dict_path = argv[i];
+        } else {
+            fprintf(stderr, "Usage: %s [dictionary] [--rounds N]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (rounds < 1) rounds = 1;
+
+    key_list_t keys = {0}, misses = {0};
+    if (!load_keys(dict_path, &keys)) return 1;
+    char buf[MAX_LINE_BUFFER];
+    for (size_t i = 0; i < keys.count; i++) {
+        snprintf(buf, sizeof(buf), "%s" MISS_SUFFIX, keys.items[i]);
+        if (!keys_add(&misses, buf)) return 1;
+    }
+    size_t n = keys.count;
+    size_t* order = malloc(n * sizeof(size_t));
+    uint64_t* hashes = malloc(n * sizeof(uint64_t));
+    uint64_t* miss_hashes = malloc(n * sizeof(uint64_t));
+    if (!order || !hashes || !miss_hashes) return 1;
+    for (size_t i = 0; i < n; i++) {
+        order[i] = i;
+        hashes[i] = xxh3(keys.items[i], strlen(keys.items[i]));
+        miss_hashes[i] = xxh3(misses.items[i], strlen(misses.items[i]));
+    }
+
+    printf("hash.h benchmark: %zu keys, %d rounds (best round reported)\n", n, rounds);
+
+    uint64_t best[2][PHASE_COUNT];
+    for (int p = 0; p < PHASE_COUNT; p++) best[0][p] = best[1][p] = UINT64_MAX;
+    uint64_t rng = 0x4a5bULL;
+    size_t errors = 0;
+
+    for (int r = 0; r < rounds; r++) {
+        uint64_t elapsed[2][PHASE_COUNT];
+        errors += run_string_round(&keys, &misses, order, &rng, elapsed[0], r == 0);
+        errors += run_typed_round(hashes, miss_hashes, n, order, &rng, elapsed[1]);
+        for (int t = 0; t < 2; t++) {
+            for (int p = 0; p < PHASE_COUNT; p++) {
+                if (elapsed[t][p] < best[t][p]) best[t][p] = elapsed[t][p];
+            }
+        }
+    }
+
+    printf("\nns/op      %12s %12s\n", "HT_TABLE", "HT_DEFINE");
+    printf("%-10s %12s %12s\n", "", "(char *)", "(uint64_t)");
+    for (int p = 0; p < PHASE_COUNT; p++) {
+        printf("%-10s %12.1f %12.1f\n", PHASE_NAMES[p],
+               (double)best[0][p] / (double)n, (double)best[1][p] / (double)n);
+    }
+
+    bench_xxh3(&keys, &rng, rounds);
+    size_t xxh3_mismatches = check_xxh3(&rng);
+    if (xxh3_mismatches) {
+        fprintf(stderr, "\n%zu xxh3 hashes differ from the portable path\n", xxh3_mismatches);
+        errors += xxh3_mismatches;
+    }
+
+    if (errors) fprintf(stderr, "\n%zu operations returned the wrong result\n", errors);
+    free(order);
+    free(hashes);
+    free(miss_hashes);
+    keys_free(&misses);
+    keys_free(&keys);
+    return errors ? 1 : 0;
+}
@@ -2,22 +2,31 @@
  * benchmark_symspell.c - Benchmark tool for the clean SymSpell implementation.
  *
  * Measures dictionary load time and average lookup performance against a
- * test file of misspellings.
+ * test file of misspellings. With --perf, hardware counters are read around
+ * every lookup and reported per lookup for the exact and fuzzy paths. With
+ * --pages, the referenced bits of the process are cleared
+ * (/proc/self/clear_refs) before every PAGE_WINDOW lookups and the distinct
+ * pages they touched are read back from /proc/self/smaps_rollup, giving the
+ * working set of a burst of traffic. A whole run touches nearly every page
+ * of the delete table, so only short windows tell layouts apart.
  */
 
 #define _GNU_SOURCE
 #define _POSIX_C_SOURCE 200809L
 
 #include "symspell.h"
+#include "perf_counters.h"
+#include "posix.h"
 #include <stdio.h>
 #include <string.h>
 #include <time.h>
 
 #define SYMSPELL_MAX_TERM_LENGTH 128
-#define MAX_LINE_BUFFER 8192        
 #define ITERATIONS 100
 #define EDIT_DISTANCE 2
 #define PREFIX_LENGTH 7
+#define PAGE_KB 4
+#define PAGE_WINDOW 100
 
 /* High-precision timing function */
 static double get_time_ms() {
@@ -26,11 +35,37 @@ static double get_time_ms() {
     return (double)ts.tv_sec * 1000.0 + (double)ts.tv_nsec / 1000000.0;
 }
 
+/* Clear the referenced bit of every page of the process; false if unsupported */
+static bool clear_referenced(void) {
+    FILE* fp = fopen("/proc/self/clear_refs", "w");
+    if (!fp) return false;
+    bool ok = fputs("1", fp) >= 0;
+    return fclose(fp) == 0 && ok;
+}
+
+/* Kilobytes referenced since clear_referenced(), or -1 */
+static long referenced_kb(void) {
+    FILE* fp = fopen("/proc/self/smaps_rollup", "r");
+    if (!fp) return -1;
+    char line[256];
+    long kb = -1;
+    while (fgets(line, sizeof(line), fp)) {
+        if (sscanf(line, "Referenced: %ld kB", &kb) == 1) break;
+    }
+    fclose(fp);
+    return kb;
+}
+
 int main(int argc, char* argv[]) {
     if (argc < 3) {
-        fprintf(stderr, "Usage: %s <dictionary_file> <test_file>\n", argv[0]);
+        fprintf(stderr, "Usage: %s <dictionary_file> <test_file> [--perf] [--pages]\n", argv[0]);
         return 1;
     }
+    int perf_mode = 0, pages_mode = 0;
+    for (int i = 3; i < argc; i++) {
+        if (strcmp(argv[i], "--perf") == 0) perf_mode = 1;
+        else if (strcmp(argv[i], "--pages") == 0) pages_mode = 1;
+    }
 
     /* --- 0. Check dictionary and test file exist --- */
     FILE* check_dict = fopen(argv[1], "r");
@@ -82,27 +117,55 @@ int main(int argc, char* argv[]) {
         return 1;
     }
 
+    /* Optional hardware counters, read around each lookup */
+    perf_counters_t perf;
+    perf_totals_t perf_exact = {0}, perf_fuzzy = {0};
+    if (perf_mode && !perf_counters_open(&perf)) {
+        fprintf(stderr, "Warning: hardware counters unavailable (perf_event_open failed), "
+                        "continuing without them\n");
+        perf_mode = 0;
+    }
+    uint64_t perf_before[PERF_COUNTER_COUNT], perf_after[PERF_COUNTER_COUNT];
+
+    if (pages_mode && (!clear_referenced() || referenced_kb() < 0)) {
+        fprintf(stderr, "Warning: page reference bits unavailable, continuing without --pages\n");
+        pages_mode = 0;
+    }
+
     printf("Running benchmark against: %s\n", argv[2]);
     
     int total = 0, correct = 0;
+    double window_kb = 0;
+    int window_count = 0;
     double total_lookup_time_ms = 0;
-    char line[MAX_LINE_BUFFER];
+    c_reader_t* reader = c_reader_open(fp);
+    char* line;
     
-    while (fgets(line, sizeof(line), fp)) {
-        line[strcspn(line, "\r\n")] = 0;
-
+    while (reader && (line = c_reader_next_line(reader, NULL))) {
         char misspelled[SYMSPELL_MAX_TERM_LENGTH], expected[SYMSPELL_MAX_TERM_LENGTH];
         if (sscanf(line, "%127s\t%127s", misspelled, expected) != 2) continue;
         
         total++;
+        if (pages_mode && total % PAGE_WINDOW == 1) clear_referenced();
         
         symspell_suggestion_t suggestions[5];
         
+        if (perf_mode) perf_counters_read(&perf, perf_before);
         double start_lookup = get_time_ms();
         int count = symspell_lookup(dict, misspelled, 2, suggestions, 5);
         double end_lookup = get_time_ms();
+        if (perf_mode) {
+            perf_counters_read(&perf, perf_after);
+            /* Exact-table hits return a single distance-0 suggestion */
+            int exact = (count > 0 && suggestions[0].distance == 0);
+            perf_totals_add(exact ? &perf_exact : &perf_fuzzy, perf_before, perf_after);
+        }
         
         total_lookup_time_ms += (end_lookup - start_lookup);
+        if (pages_mode && total % PAGE_WINDOW == 0) {
+            window_kb += referenced_kb();
+            window_count++;
+        }
         
         if (count > 0 && strcmp(suggestions[0].term, expected) == 0) {
             correct++;
@@ -119,6 +182,7 @@ int main(int argc, char* argv[]) {
     }
     fprintf(stderr, "\rProcessed: %d... Done.\n\n", total);
     
+    c_reader_close(reader);
     fclose(fp);
     fclose(errors_fp);
 
@@ -135,6 +199,24 @@ int main(int argc, char* argv[]) {
     printf("Dictionary load time: %.2f ms\n", load_time_ms);
     printf("Total lookup time:    %.2f ms (for %d lookups)\n", total_lookup_time_ms, total);
     printf("Average lookup time:  %.3f ms (%.1f µs)\n", avg_lookup_ms, avg_lookup_us);
+
+    if (window_count > 0) {
+        printf("Pages touched:        %.0f per %d lookups (%.2f MB)\n",
+               window_kb / window_count / PAGE_KB, PAGE_WINDOW, window_kb / window_count / 1024.0);
+    }
+
+    if (perf_mode) {
+        perf_totals_t perf_all = perf_exact;
+        perf_all.regions += perf_fuzzy.regions;
+        for (int i = 0; i < PERF_COUNTER_COUNT; i++) perf_all.counts[i] += perf_fuzzy.counts[i];
+
+        printf("\n--- Hardware Counters (per lookup, user space) ---\n");
+        perf_totals_print_header(stdout);
+        perf_totals_print(&perf, "exact", &perf_exact, stdout);
+        perf_totals_print(&perf, "fuzzy", &perf_fuzzy, stdout);
+        perf_totals_print(&perf, "all", &perf_all, stdout);
+        perf_counters_close(&perf);
+    }
     
     printf("\nError cases written to errors.txt\n");
     
@@ -0,0 +1,439 @@
+/*
+ * coldstart_symspell.c - Cold-start and first-query latency benchmark.
+ *
+ * Measures what a freshly deployed process experiences rather than warm
+ * steady state: time until the dictionary is ready, latency of the first N
+ * lookups, and the page faults and resident memory growth behind both.
+ * Three startup paths are compared:
+ *
+ *   text    symspell_create() + symspell_load_dictionary()
+ *   binary  symspell_load_index(SYMSPELL_INDEX_READ)
+ *   mmap    symspell_load_index(SYMSPELL_INDEX_MMAP)
+ *   hot     the same on an image from symspell_save_index_profiled(), laid
+ *           out for the queries of --profile FILE (a misspelling corpus or
+ *           a .sst query trace); compare its lookup faults with mmap
+ *
+ * Each path runs in its own child process. Before each run the dictionary
+ * and index files are evicted from the page cache (posix_fadvise), and with
+ * --drop-caches the whole page cache is dropped when permitted (root).
+ */
+
+#define _GNU_SOURCE
+#define _POSIX_C_SOURCE 200809L
+
+#include "symspell.h"
+#include "symspell_trace.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+
+#define SYMSPELL_MAX_TERM_LENGTH 128
+#define MAX_LINE_BUFFER 8192
+#define EDIT_DISTANCE 2
+#define PREFIX_LENGTH 7
+#define MAX_SUGGESTIONS 5
+#define DEFAULT_FIRST_N 1000
+#define DEFAULT_INDEX "dictionary.idx"
+#define DEFAULT_HOT_INDEX "dictionary-hot.idx"
+
+typedef enum { MODE_TEXT, MODE_BINARY, MODE_MMAP, MODE_HOT, MODE_COUNT } start_mode_t;
+
+static const char* MODE_NAMES[MODE_COUNT] = { "text", "binary", "mmap", "hot" };
+
+/* Resource usage at one point in time */
+typedef struct {
+    double ms;
+    long minflt;
+    long majflt;
+    double rss_mb;
+} usage_point_t;
+
+/* Result of one startup path, sent from the child over a pipe */
+typedef struct {
+    int ok;
+    double ready_ms;
+    long load_minflt, load_majflt;
+    double load_rss_mb;
+    double first_us;               /* The very first lookup */
+    double first_mean_us, first_p50_us, first_p99_us, first_max_us;
+    long lookup_minflt, lookup_majflt;
+    double lookup_rss_mb;
+    double warm_mean_us, warm_p99_us;
+    size_t lookups;
+} coldstart_result_t;
+
+static double get_time_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1000.0 + (double)ts.tv_nsec / 1000000.0;
+}
+
+static double resident_mb(void) {
+    FILE* fp = fopen("/proc/self/statm", "r");
+    if (fp) {
+        long size, resident;
+        int n = fscanf(fp, "%ld %ld", &size, &resident);
+        fclose(fp);
+        if (n == 2) return (double)resident * (double)sysconf(_SC_PAGESIZE) / (1024.0 * 1024.0);
+    }
+    struct rusage ru;
+    getrusage(RUSAGE_SELF, &ru);
+    return (double)ru.ru_maxrss / 1024.0;
+}
+
+static usage_point_t usage_now(void) {
+    usage_point_t u;
+    struct rusage ru;
+    getrusage(RUSAGE_SELF, &ru);
+    u.ms = get_time_ms();
+    u.minflt = ru.ru_minflt;
+    u.majflt = ru.ru_majflt;
+    u.rss_mb = resident_mb();
+    return u;
+}
+
+static int compare_double(const void* a, const void* b) {
+    double x = *(const double*)a;
+    double y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+static double percentile(const double* sorted, size_t n, double p) {
+    if (n == 0) return 0.0;
+    size_t rank = (size_t)(p / 100.0 * (double)n);
+    if (rank >= n) rank = n - 1;
+    return sorted[rank];
+}
+
+/* Evict a file's pages from the page cache; false if it could not be opened */
+static int evict_file(const char* filepath) {
+    int fd = open(filepath, O_RDONLY);
+    if (fd < 0) return 0;
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    close(fd);
+    return 1;
+}
+
+/* Drop the whole page cache (needs root); returns 1 on success */
+static int drop_page_cache(void) {
+    sync();
+    FILE* fp = fopen("/proc/sys/vm/drop_caches", "w");
+    if (!fp) return 0;
+    int ok = fputs("3\n", fp) >= 0;
+    if (fclose(fp) != 0) ok = 0;
+    return ok;
+}
+
+/* Read up to max misspelled terms from a test file */
+static char (*read_queries(const char* filepath, size_t max, size_t* count))[SYMSPELL_MAX_TERM_LENGTH] {
+    char (*queries)[SYMSPELL_MAX_TERM_LENGTH] = malloc(max * sizeof(*queries));
+    *count = 0;
+    if (!queries) return NULL;
+    FILE* fp = fopen(filepath, "r");
+    if (!fp) {
+        fprintf(stderr, "Failed to open test file: %s\n", filepath);
+        free(queries);
+        return NULL;
+    }
+    char line[MAX_LINE_BUFFER];
+    while (*count < max && fgets(line, sizeof(line), fp)) {
+        if (sscanf(line, "%127s", queries[*count]) == 1) (*count)++;
+    }
+    fclose(fp);
+    return queries;
+}
+
+/* Read every profile query: the terms of a query trace, or the first column of a text file */
+static char** read_profile(const char* filepath, size_t* count) {
+    char** terms = NULL;
+    size_t capacity = 0;
+    *count = 0;
+    symspell_trace_reader_t* trace = symspell_trace_reader_open(filepath);
+    FILE* fp = trace ? NULL : fopen(filepath, "r");
+    if (!trace && !fp) {
+        fprintf(stderr, "Failed to open profile: %s\n", filepath);
+        return NULL;
+    }
+    symspell_trace_record_t record;
+    char line[MAX_LINE_BUFFER];
+    char term[SYMSPELL_MAX_TERM_LENGTH];
+    for (;;) {
+        if (trace) {
+            if (!symspell_trace_read(trace, &record)) break;
+            snprintf(term, sizeof(term), "%s", record.term);
+        } else {
+            if (!fgets(line, sizeof(line), fp)) break;
+            if (sscanf(line, "%127s", term) != 1) continue;
+        }
+        if (*count == capacity) {
+            size_t grown_capacity = capacity ? capacity * 2 : 1024;
+            char** grown = realloc(terms, grown_capacity * sizeof(char*));
+            if (!grown) break;
+            terms = grown;
+            capacity = grown_capacity;
+        }
+        if (!(terms[*count] = strdup(term))) break;
+        (*count)++;
+    }
+    if (trace) symspell_trace_reader_close(trace);
+    if (fp) fclose(fp);
+    return terms;
+}
+
+/*
+ * Build an index image from the text dictionary (child process), laid out
+ * for the profile queries when there are any
+ */
+static int build_index(const char* dict_path, const char* index_path,
+                       char* const* profile, size_t profile_count) {
+    symspell_dict_t* dict = symspell_create(EDIT_DISTANCE, PREFIX_LENGTH);
+    int ok = dict && symspell_load_dictionary(dict, dict_path, 0, 1);
+    if (ok && profile) {
+        ok = symspell_save_index_profiled(dict, index_path, (const char* const*)profile,
+                                          profile_count, EDIT_DISTANCE);
+    } else if (ok) {
+        ok = symspell_save_index(dict, index_path);
+    }
+    if (dict) symspell_destroy(dict);
+    return ok;
+}
+
+/* Build an index image in a child process; returns 1 on success */
+static int build_index_isolated(const char* dict_path, const char* index_path,
+                                char* const* profile, size_t profile_count) {
+    printf("Building %sindex %s from %s...\n", profile ? "profiled " : "", index_path, dict_path);
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid == 0) {
+        if (!freopen("/dev/null", "w", stdout) || !freopen("/dev/null", "w", stderr)) _exit(1);
+        _exit(build_index(dict_path, index_path, profile, profile_count) ? 0 : 1);
+    }
+    int status = 0;
+    if (pid < 0 || waitpid(pid, &status, 0) < 0 || !WIFEXITED(status) ||
+        WEXITSTATUS(status) != 0) {
+        fprintf(stderr, "Failed to build index %s\n", index_path);
+        return 0;
+    }
+    return 1;
+}
+
+static void run_mode(coldstart_result_t* r, start_mode_t mode, const char* dict_path,
+                     const char* index_path, char (*queries)[SYMSPELL_MAX_TERM_LENGTH],
+                     size_t count) {
+    double* latencies = malloc((count ? count : 1) * sizeof(double));
+    if (!latencies) return;
+
+    /* --- Time to ready --- */
+    usage_point_t before = usage_now();
+    symspell_dict_t* dict = NULL;
+    if (mode == MODE_TEXT) {
+        dict = symspell_create(EDIT_DISTANCE, PREFIX_LENGTH);
+        if (dict && !symspell_load_dictionary(dict, dict_path, 0, 1)) {
+            symspell_destroy(dict);
+            dict = NULL;
+        }
+    } else {
+        dict = symspell_load_index(index_path, mode == MODE_BINARY ? SYMSPELL_INDEX_READ
+                                                                   : SYMSPELL_INDEX_MMAP);
+    }
+    usage_point_t ready = usage_now();
+    if (!dict) {
+        free(latencies);
+        return;
+    }
+    r->ready_ms = ready.ms - before.ms;
+    r->load_minflt = ready.minflt - before.minflt;
+    r->load_majflt = ready.majflt - before.majflt;
+    r->load_rss_mb = ready.rss_mb - before.rss_mb;
+
+    /* --- First N lookups, in arrival order --- */
+    symspell_suggestion_t suggestions[MAX_SUGGESTIONS];
+    for (size_t i = 0; i < count; i++) {
+        double t0 = get_time_ms();
+        symspell_lookup(dict, queries[i], EDIT_DISTANCE, suggestions, MAX_SUGGESTIONS);
+        latencies[i] = (get_time_ms() - t0) * 1000.0;
+    }
+    usage_point_t after = usage_now();
+    r->lookup_minflt = after.minflt - ready.minflt;
+    r->lookup_majflt = after.majflt - ready.majflt;
+    r->lookup_rss_mb = after.rss_mb - ready.rss_mb;
+    r->first_us = count ? latencies[0] : 0.0;
+
+    double sum = 0;
+    for (size_t i = 0; i < count; i++) sum += latencies[i];
+    r->first_mean_us = count ? sum / (double)count : 0.0;
+    qsort(latencies, count, sizeof(double), compare_double);
+    r->first_p50_us = percentile(latencies, count, 50.0);
+    r->first_p99_us = percentile(latencies, count, 99.0);
+    r->first_max_us = count ? latencies[count - 1] : 0.0;
+
+    /* --- The same queries again, warm --- */
+    sum = 0;
+    for (size_t i = 0; i < count; i++) {
+        double t0 = get_time_ms();
+        symspell_lookup(dict, queries[i], EDIT_DISTANCE, suggestions, MAX_SUGGESTIONS);
+        latencies[i] = (get_time_ms() - t0) * 1000.0;
+        sum += latencies[i];
+    }
+    qsort(latencies, count, sizeof(double), compare_double);
+    r->warm_mean_us = count ? sum / (double)count : 0.0;
+    r->warm_p99_us = percentile(latencies, count, 99.0);
+    r->lookups = count;
+    r->ok = 1;
+
+    symspell_destroy(dict);
+    free(latencies);
+}
+
+/* Run one startup path in a fresh child; the result comes back over a pipe */
+static void run_isolated(coldstart_result_t* r, start_mode_t mode, const char* dict_path,
+                         const char* index_path, char (*queries)[SYMSPELL_MAX_TERM_LENGTH],
+                         size_t count) {
+    int fds[2];
+    if (pipe(fds) != 0) {
+        perror("pipe");
+        return;
+    }
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid < 0) {
+        perror("fork");
+        close(fds[0]);
+        close(fds[1]);
+        return;
+    }
+    if (pid == 0) {
+        close(fds[0]);
+        /* Keep the loader's progress output out of the report */
+        if (!freopen("/dev/null", "w", stdout) || !freopen("/dev/null", "w", stderr)) _exit(1);
+        run_mode(r, mode, dict_path, index_path, queries, count);
+        ssize_t written = write(fds[1], r, sizeof(*r));
+        _exit(written == (ssize_t)sizeof(*r) ? 0 : 1);
+    }
+    close(fds[1]);
+    coldstart_result_t child;
+    if (read(fds[0], &child, sizeof(child)) == (ssize_t)sizeof(child)) *r = child;
+    close(fds[0]);
+    waitpid(pid, NULL, 0);
+}
+
+static void usage(const char* prog) {
+    fprintf(stderr, "Usage: %s <dictionary_file> <test_file> [options]\n", prog);
+    fprintf(stderr, "  --index FILE      Index image (default %s, built if missing)\n", DEFAULT_INDEX);
+    fprintf(stderr, "  --rebuild         Rebuild the index image first\n");
+    fprintf(stderr, "  --first N         Lookups measured after startup (default %d)\n", DEFAULT_FIRST_N);
+    fprintf(stderr, "  --mode M          text, binary, mmap, hot or all (default all)\n");
+    fprintf(stderr, "  --profile FILE    Queries (test file or .sst trace) to lay out the hot image for\n");
+    fprintf(stderr, "  --hot-index FILE  Profiled index image (default %s, built if missing)\n",
+            DEFAULT_HOT_INDEX);
+    fprintf(stderr, "  --drop-caches     Also drop the whole page cache before each run (root)\n");
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        usage(argv[0]);
+        return 1;
+    }
+    const char* dict_path = argv[1];
+    const char* test_path = argv[2];
+    const char* index_path = DEFAULT_INDEX;
+    const char* hot_index_path = DEFAULT_HOT_INDEX;
+    const char* profile_path = NULL;
+    size_t first_n = DEFAULT_FIRST_N;
+    int rebuild = 0, drop_caches = 0;
+    int modes[MODE_COUNT] = {1, 1, 1, 1};
+
+    for (int i = 3; i < argc; i++) {
+        if (strcmp(argv[i], "--rebuild") == 0) {
+            rebuild = 1;
+        } else if (strcmp(argv[i], "--drop-caches") == 0) {
+            drop_caches = 1;
+        } else if (i + 1 < argc && strcmp(argv[i], "--index") == 0) {
+            index_path = argv[++i];
+        } else if (i + 1 < argc && strcmp(argv[i], "--hot-index") == 0) {
+            hot_index_path = argv[++i];
+        } else if (i + 1 < argc && strcmp(argv[i], "--profile") == 0) {
+            profile_path = argv[++i];
+        } else if (i + 1 < argc && strcmp(argv[i], "--first") == 0) {
+            first_n = (size_t)atol(argv[++i]);
+        } else if (i + 1 < argc && strcmp(argv[i], "--mode") == 0) {
+            const char* m = argv[++i];
+            if (strcmp(m, "all") != 0) {
+                for (int k = 0; k < MODE_COUNT; k++) modes[k] = strcmp(m, MODE_NAMES[k]) == 0;
+            }
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    /* The hot image only exists for a profile */
+    if (!profile_path) modes[MODE_HOT] = 0;
+
+    size_t count = 0;
+    char (*queries)[SYMSPELL_MAX_TERM_LENGTH] = read_queries(test_path, first_n ? first_n : 1, &count);
+    if (!queries) return 1;
+
+    struct stat st;
+    int built = 1;
+    if ((modes[MODE_BINARY] || modes[MODE_MMAP]) && (rebuild || stat(index_path, &st) != 0)) {
+        built = build_index_isolated(dict_path, index_path, NULL, 0);
+    }
+    if (built && modes[MODE_HOT] && (rebuild || stat(hot_index_path, &st) != 0)) {
+        size_t profile_count = 0;
+        char** profile = read_profile(profile_path, &profile_count);
+        built = profile && build_index_isolated(dict_path, hot_index_path, profile, profile_count);
+        for (size_t i = 0; profile && i < profile_count; i++) free(profile[i]);
+        free(profile);
+    }
+    if (!built) {
+        free(queries);
+        return 1;
+    }
+
+    coldstart_result_t results[MODE_COUNT];
+    int dropped = 0;
+    for (int k = 0; k < MODE_COUNT; k++) {
+        memset(&results[k], 0, sizeof(results[k]));
+        if (!modes[k]) continue;
+        evict_file(dict_path);
+        evict_file(index_path);
+        evict_file(hot_index_path);
+        if (drop_caches) dropped = drop_page_cache();
+        fprintf(stderr, "Running %s startup...\n", MODE_NAMES[k]);
+        run_isolated(&results[k], (start_mode_t)k, dict_path,
+                     k == MODE_HOT ? hot_index_path : index_path, queries, count);
+    }
+
+    printf("\nCold start: %zu lookups from %s, page cache %s\n\n", count, test_path,
+           dropped ? "dropped" : "evicted for input files");
+    printf("%-7s %10s %9s %7s %8s | %9s %9s %9s %9s %9s %9s %7s %8s | %9s %9s\n",
+           "mode", "ready_ms", "minflt", "majflt", "rss_mb",
+           "first_us", "mean_us", "p50_us", "p99_us", "max_us", "minflt", "majflt", "rss_mb",
+           "warm_us", "warm_p99");
+    for (int k = 0; k < MODE_COUNT; k++) {
+        const coldstart_result_t* r = &results[k];
+        if (!modes[k]) continue;
+        if (!r->ok) {
+            printf("%-7s FAILED\n", MODE_NAMES[k]);
+            continue;
+        }
+        printf("%-7s %10.1f %9ld %7ld %8.1f | %9.1f %9.1f %9.1f %9.1f %9.1f %9ld %7ld %8.1f | %9.1f %9.1f\n",
+               MODE_NAMES[k], r->ready_ms, r->load_minflt, r->load_majflt, r->load_rss_mb,
+               r->first_us, r->first_mean_us, r->first_p50_us, r->first_p99_us, r->first_max_us,
+               r->lookup_minflt, r->lookup_majflt, r->lookup_rss_mb,
+               r->warm_mean_us, r->warm_p99_us);
+    }
+    printf("\nLeft: startup (time to ready, faults and RSS growth while loading).\n");
+    printf("Middle: first %zu lookups after ready. Right: the same lookups again, warm.\n", count);
+
+    free(queries);
+    return 0;
+}
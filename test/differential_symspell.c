@@ -0,0 +1,410 @@
+/*
+ * differential_symspell.c - Optimized engine vs. reference engine.
+ *
+ * Loads the same dictionary into src/symspell.c and into the original lookup
+ * kept as a reference engine (src/symspell_reference.c) and runs every query
+ * through both:
+ *
+ *   corpus   both columns of every file in test/data/symspell/misspellings
+ *   edge     empty, single-byte, mixed-case, 127-byte and over-long queries
+ *   random   random strings over letters, and over letters, digits and
+ *            punctuation
+ *   fuzz     dictionary words with 1-3 random edits (insert, delete,
+ *            substitute, transpose), some upper-cased or carrying digits
+ *            and non-ASCII bytes
+ *
+ * Each query is looked up at the dictionary's max_edit_distance and at 1.
+ * Any difference in result count, term, distance or frequency is a mismatch;
+ * the first few are printed, all of them are written to the mismatch file,
+ * and the exit status is 1.
+ *
+ * --verify-threads N splits the verification of every lookup over N helper
+ * threads, checking that the merged result matches the sequential one.
+ *
+ * Build: make differential_symspell (compiles with SYMSPELL_REFERENCE_ENGINE)
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "symspell.h"
+#include "symspell_reference.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifndef SYMSPELL_REFERENCE_ENGINE
+#error "differential_symspell needs -DSYMSPELL_REFERENCE_ENGINE"
+#endif
+
+#define SYMSPELL_MAX_TERM_LENGTH 128
+#define MAX_LINE_BUFFER 8192
+#define MAX_SUGGESTIONS 5
+#define DEFAULT_DICTIONARY "dictionaries/dictionary.txt"
+#define DEFAULT_CORPUS_DIR "test/data/symspell/misspellings"
+#define DEFAULT_MISMATCH_FILE "differential-mismatches.txt"
+#define DEFAULT_EDIT_DISTANCE 2
+#define DEFAULT_PREFIX_LENGTH 7
+#define DEFAULT_RANDOM 20000
+#define DEFAULT_FUZZ 50000
+#define DEFAULT_SEED 0xd1ff5eedULL
+#define MAX_PRINTED_MISMATCHES 10
+#define MAX_QUERY_LENGTH (SYMSPELL_MAX_TERM_LENGTH - 1)
+
+static const char* const CORPUS_FILES[] = {
+    "misspell-codespell.txt",
+    "misspell-wikipedia.txt",
+    "misspell-microsoft.txt",
+    "misspell-words.go.txt",
+};
+#define CORPUS_COUNT ((int)(sizeof(CORPUS_FILES) / sizeof(CORPUS_FILES[0])))
+
+static const char LETTERS[] = "abcdefghijklmnopqrstuvwxyz";
+static const char WIDE_ALPHABET[] = "abcdefghijklmnopqrstuvwxyzABCXYZ0123456789'-_.";
+
+typedef struct {
+    char** items;
+    size_t count;
+    size_t capacity;
+} string_list_t;
+
+typedef struct {
+    const symspell_dict_t* dict;
+    const symspell_reference_t* ref;
+    int distances[2];
+    int distance_count;
+    FILE* mismatch_fp;
+    unsigned long queries;
+    unsigned long lookups;
+    unsigned long mismatches;
+} differential_t;
+
+/* xorshift64*: deterministic across platforms, unlike rand() */
+static uint64_t next_random(uint64_t* state) {
+    uint64_t x = *state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    *state = x;
+    return x * 0x2545F4914F6CDD1DULL;
+}
+
+static int list_add(string_list_t* list, const char* s) {
+    if (list->count == list->capacity) {
+        size_t new_cap = list->capacity ? list->capacity * 2 : 1024;
+        char** grown = realloc(list->items, new_cap * sizeof(char*));
+        if (!grown) return 0;
+        list->items = grown;
+        list->capacity = new_cap;
+    }
+    size_t len = strlen(s);
+    list->items[list->count] = malloc(len + 1);
+    if (!list->items[list->count]) return 0;
+    memcpy(list->items[list->count], s, len + 1);
+    list->count++;
+    return 1;
+}
+
+static void list_free(string_list_t* list) {
+    for (size_t i = 0; i < list->count; i++) free(list->items[i]);
+    free(list->items);
+    memset(list, 0, sizeof(*list));
+}
+
+static void print_result(FILE* out, const char* engine, const symspell_suggestion_t* s, int n) {
+    fprintf(out, "  %-9s %d:", engine, n);
+    for (int i = 0; i < n; i++) {
+        fprintf(out, " %s/%d/%llu", s[i].term, s[i].distance, (unsigned long long)s[i].frequency);
+    }
+    fprintf(out, "\n");
+}
+
+/* Run one query through both engines at every distance */
+static void check_query(differential_t* diff, const char* source, const char* query) {
+    diff->queries++;
+    for (int d = 0; d < diff->distance_count; d++) {
+        symspell_suggestion_t got[MAX_SUGGESTIONS], want[MAX_SUGGESTIONS];
+        memset(got, 0, sizeof(got));
+        memset(want, 0, sizeof(want));
+        int n_got = symspell_lookup(diff->dict, query, diff->distances[d], got, MAX_SUGGESTIONS);
+        int n_want = symspell_reference_lookup(diff->ref, query, diff->distances[d], want, MAX_SUGGESTIONS);
+        diff->lookups++;
+
+        int same = (n_got == n_want);
+        for (int i = 0; same && i < n_got; i++) {
+            same = strcmp(got[i].term, want[i].term) == 0 &&
+                   got[i].distance == want[i].distance &&
+                   got[i].frequency == want[i].frequency;
+        }
+        if (same) continue;
+
+        diff->mismatches++;
+        FILE* outs[2] = { diff->mismatches <= MAX_PRINTED_MISMATCHES ? stdout : NULL,
+                          diff->mismatch_fp };
+        for (int o = 0; o < 2; o++) {
+            if (!outs[o]) continue;
+            fprintf(outs[o], "MISMATCH [%s] d=%d query=\"%s\"\n", source, diff->distances[d], query);
+            print_result(outs[o], "optimized", got, n_got);
+            print_result(outs[o], "reference", want, n_want);
+        }
+    }
+}
+
+static int check_corpora(differential_t* diff, const char* corpus_dir) {
+    for (int c = 0; c < CORPUS_COUNT; c++) {
+        char path[MAX_LINE_BUFFER];
+        snprintf(path, sizeof(path), "%s/%s", corpus_dir, CORPUS_FILES[c]);
+        FILE* fp = fopen(path, "r");
+        if (!fp) {
+            fprintf(stderr, "Error: corpus not found: %s\n", path);
+            return 0;
+        }
+        char line[MAX_LINE_BUFFER];
+        while (fgets(line, sizeof(line), fp)) {
+            line[strcspn(line, "\r\n")] = '\0';
+            char* column = strtok(line, " \t");
+            for (int k = 0; column && k < 2; k++) {
+                check_query(diff, CORPUS_FILES[c], column);
+                column = strtok(NULL, " \t");
+            }
+        }
+        fclose(fp);
+    }
+    return 1;
+}
+
+static void check_edge_cases(differential_t* diff) {
+    char buf[MAX_LINE_BUFFER];
+    static const char* const fixed[] = {
+        "", "a", "z", "I", "A", "ab", "The", "HELLO", "Teh", "recieve", "x'y", "--", "0", "42",
+    };
+    for (size_t i = 0; i < sizeof(fixed) / sizeof(fixed[0]); i++) {
+        check_query(diff, "edge", fixed[i]);
+    }
+    static const size_t lengths[] = { MAX_QUERY_LENGTH - 1, MAX_QUERY_LENGTH, MAX_QUERY_LENGTH + 1, 200 };
+    for (size_t i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++) {
+        memset(buf, 'e', lengths[i]);
+        buf[lengths[i]] = '\0';
+        check_query(diff, "edge", buf);
+        /* Dictionary word at the start, noise after the truncation point */
+        memcpy(buf, "because", 7);
+        check_query(diff, "edge", buf);
+    }
+}
+
+static void check_random(differential_t* diff, uint64_t* rng, long count) {
+    char buf[SYMSPELL_MAX_TERM_LENGTH];
+    for (long i = 0; i < count; i++) {
+        int wide = (i % 4) == 3;
+        const char* alphabet = wide ? WIDE_ALPHABET : LETTERS;
+        size_t alphabet_size = wide ? sizeof(WIDE_ALPHABET) - 1 : sizeof(LETTERS) - 1;
+        /* Mostly word-like lengths, occasionally up to the maximum */
+        size_t length = (i % 50) == 49 ? 1 + next_random(rng) % MAX_QUERY_LENGTH
+                                       : 1 + next_random(rng) % 16;
+        for (size_t k = 0; k < length; k++) buf[k] = alphabet[next_random(rng) % alphabet_size];
+        buf[length] = '\0';
+        check_query(diff, "random", buf);
+    }
+}
+
+/* One random insert, delete, substitution or transposition */
+static size_t mutate(uint64_t* rng, char* buf, size_t len) {
+    size_t pos = len ? next_random(rng) % len : 0;
+    char c = LETTERS[next_random(rng) % (sizeof(LETTERS) - 1)];
+    switch (next_random(rng) % 4) {
+    case 0:
+        if (len + 1 >= SYMSPELL_MAX_TERM_LENGTH) break;
+        memmove(buf + pos + 1, buf + pos, len - pos + 1);
+        buf[pos] = c;
+        return len + 1;
+    case 1:
+        if (len == 0) break;
+        memmove(buf + pos, buf + pos + 1, len - pos);
+        return len - 1;
+    case 2:
+        if (len == 0) break;
+        buf[pos] = c;
+        break;
+    default:
+        if (pos + 1 < len) {
+            char t = buf[pos];
+            buf[pos] = buf[pos + 1];
+            buf[pos + 1] = t;
+        }
+        break;
+    }
+    return len;
+}
+
+static void check_fuzz(differential_t* diff, uint64_t* rng, const string_list_t* seeds, long count) {
+    char buf[SYMSPELL_MAX_TERM_LENGTH];
+    if (seeds->count == 0) return;
+    for (long i = 0; i < count; i++) {
+        snprintf(buf, sizeof(buf), "%s", seeds->items[next_random(rng) % seeds->count]);
+        size_t len = strlen(buf);
+        int edits = 1 + (int)(next_random(rng) % 3);
+        for (int e = 0; e < edits; e++) len = mutate(rng, buf, len);
+
+        switch (next_random(rng) % 16) {
+        case 0:
+            for (size_t k = 0; k < len; k++) {
+                if (buf[k] >= 'a' && buf[k] <= 'z') buf[k] = (char)(buf[k] - 'a' + 'A');
+            }
+            break;
+        case 1:
+            if (len > 0) buf[next_random(rng) % len] = (char)('0' + next_random(rng) % 10);
+            break;
+        case 2:
+            if (len > 0) buf[next_random(rng) % len] = (char)(0x80 + next_random(rng) % 0x80);
+            break;
+        default:
+            break;
+        }
+        check_query(diff, "fuzz", buf);
+    }
+}
+
+/* Dictionary words (first column) as fuzz seeds */
+static int load_seeds(const char* dict_path, string_list_t* seeds) {
+    FILE* fp = fopen(dict_path, "r");
+    if (!fp) return 0;
+    char line[MAX_LINE_BUFFER];
+    int ok = 1;
+    while (ok && fgets(line, sizeof(line), fp)) {
+        char* word = strtok(line, " \t\r\n");
+        if (word && strlen(word) < SYMSPELL_MAX_TERM_LENGTH) ok = list_add(seeds, word);
+    }
+    fclose(fp);
+    return ok;
+}
+
+static double elapsed_ms(const struct timespec* start) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)(now.tv_sec - start->tv_sec) * 1000.0 +
+           (double)(now.tv_nsec - start->tv_nsec) / 1e6;
+}
+
+static void usage(const char* prog) {
+    fprintf(stderr, "Usage: %s [dictionary] [options]\n", prog);
+    fprintf(stderr, "  dictionary         dictionary file (default %s)\n", DEFAULT_DICTIONARY);
+    fprintf(stderr, "  --distance N       max_edit_distance of both engines (default %d)\n", DEFAULT_EDIT_DISTANCE);
+    fprintf(stderr, "  --prefix N         prefix_length of both engines (default %d)\n", DEFAULT_PREFIX_LENGTH);
+    fprintf(stderr, "  --corpora DIR      misspelling corpora directory (default %s)\n", DEFAULT_CORPUS_DIR);
+    fprintf(stderr, "  --random N         random queries (default %d)\n", DEFAULT_RANDOM);
+    fprintf(stderr, "  --fuzz N           fuzzed dictionary words (default %d)\n", DEFAULT_FUZZ);
+    fprintf(stderr, "  --seed S           random seed (default 0x%llx)\n", (unsigned long long)DEFAULT_SEED);
+    fprintf(stderr, "  --out FILE         mismatch report (default %s)\n", DEFAULT_MISMATCH_FILE);
+    fprintf(stderr, "  --verify-threads N split every verification over N helper threads\n");
+}
+
+int main(int argc, char* argv[]) {
+    const char* dict_path = DEFAULT_DICTIONARY;
+    const char* corpus_dir = DEFAULT_CORPUS_DIR;
+    const char* out_path = DEFAULT_MISMATCH_FILE;
+    int max_edit_distance = DEFAULT_EDIT_DISTANCE;
+    int prefix_length = DEFAULT_PREFIX_LENGTH;
+    long random_count = DEFAULT_RANDOM;
+    long fuzz_count = DEFAULT_FUZZ;
+    uint64_t seed = DEFAULT_SEED;
+    int verify_threads = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (argv[i][0] != '-') {
+            dict_path = argv[i];
+            continue;
+        }
+        if (i + 1 >= argc) {
+            usage(argv[0]);
+            return 1;
+        }
+        if (strcmp(argv[i], "--distance") == 0) {
+            max_edit_distance = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--prefix") == 0) {
+            prefix_length = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--corpora") == 0) {
+            corpus_dir = argv[++i];
+        } else if (strcmp(argv[i], "--random") == 0) {
+            random_count = atol(argv[++i]);
+        } else if (strcmp(argv[i], "--fuzz") == 0) {
+            fuzz_count = atol(argv[++i]);
+        } else if (strcmp(argv[i], "--seed") == 0) {
+            seed = strtoull(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "--out") == 0) {
+            out_path = argv[++i];
+        } else if (strcmp(argv[i], "--verify-threads") == 0) {
+            verify_threads = atoi(argv[++i]);
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (seed == 0) seed = DEFAULT_SEED;
+
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    symspell_dict_t* dict = symspell_create(max_edit_distance, prefix_length);
+    if (!dict || !symspell_load_dictionary(dict, dict_path, 0, 1)) {
+        fprintf(stderr, "Error: failed to load %s into the optimized engine\n", dict_path);
+        symspell_destroy(dict);
+        return 1;
+    }
+    printf("Optimized engine loaded in %.0f ms\n", elapsed_ms(&start));
+    /* A threshold of 0 splits every lookup, so the merge is exercised hard */
+    if (verify_threads > 0 && !symspell_set_verify_threads(dict, verify_threads, 0)) {
+        symspell_destroy(dict);
+        return 1;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    symspell_reference_t* ref = symspell_reference_create(max_edit_distance, prefix_length);
+    if (!ref || !symspell_reference_load_dictionary(ref, dict_path, 0, 1)) {
+        fprintf(stderr, "Error: failed to load %s into the reference engine\n", dict_path);
+        symspell_reference_destroy(ref);
+        symspell_destroy(dict);
+        return 1;
+    }
+    printf("Reference engine loaded in %.0f ms\n", elapsed_ms(&start));
+
+    string_list_t seeds = {0};
+    if (!load_seeds(dict_path, &seeds)) {
+        fprintf(stderr, "Error: cannot read fuzz seeds from %s\n", dict_path);
+        symspell_reference_destroy(ref);
+        symspell_destroy(dict);
+        return 1;
+    }
+
+    differential_t diff;
+    memset(&diff, 0, sizeof(diff));
+    diff.dict = dict;
+    diff.ref = ref;
+    diff.distances[diff.distance_count++] = max_edit_distance;
+    if (max_edit_distance != 1) diff.distances[diff.distance_count++] = 1;
+    diff.mismatch_fp = fopen(out_path, "w");
+    if (!diff.mismatch_fp) {
+        fprintf(stderr, "Error: cannot write %s\n", out_path);
+        list_free(&seeds);
+        symspell_reference_destroy(ref);
+        symspell_destroy(dict);
+        return 1;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    uint64_t rng = seed;
+    int ok = check_corpora(&diff, corpus_dir);
+    if (ok) {
+        check_edge_cases(&diff);
+        check_random(&diff, &rng, random_count);
+        check_fuzz(&diff, &rng, &seeds, fuzz_count);
+    }
+    fclose(diff.mismatch_fp);
+
+    printf("\n%lu queries, %lu lookups per engine, %lu mismatches (%.0f ms)\n",
+           diff.queries, diff.lookups, diff.mismatches, elapsed_ms(&start));
+    if (diff.mismatches > 0) printf("All mismatches written to %s\n", out_path);
+
+    list_free(&seeds);
+    symspell_reference_destroy(ref);
+    symspell_destroy(dict);
+    return (ok && diff.mismatches == 0) ? 0 : 1;
+}
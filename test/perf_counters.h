@@ -0,0 +1,219 @@
+/*
+ * perf_counters.h - Hardware performance counters for the benchmarks
+ *
+ * Thin header-only wrapper around Linux perf_event_open(2). Opens a group of
+ * user-space counters (cycles, instructions, L1D/LLC read misses, dTLB read
+ * misses, branch misses) on the calling thread; a snapshot is one read(2) of
+ * the whole group, so wrapping a timed region costs two system calls.
+ *
+ *     perf_counters_t pc;
+ *     perf_counters_open(&pc);
+ *     uint64_t before[PERF_COUNTER_COUNT], after[PERF_COUNTER_COUNT];
+ *     perf_counters_read(&pc, before);
+ *     ... timed region ...
+ *     perf_counters_read(&pc, after);
+ *     perf_counters_close(&pc);
+ *
+ * Counters that cannot be opened (containers, perf_event_paranoid, VMs
+ * without a PMU, non-Linux systems) are marked unavailable and read as 0;
+ * perf_counters_open() returns false when none is available, and callers
+ * simply skip the report.
+ */
+
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+typedef enum {
+    PERF_COUNTER_CYCLES,
+    PERF_COUNTER_INSTRUCTIONS,
+    PERF_COUNTER_L1D_MISSES,
+    PERF_COUNTER_LLC_MISSES,
+    PERF_COUNTER_DTLB_MISSES,
+    PERF_COUNTER_BRANCH_MISSES,
+    PERF_COUNTER_COUNT
+} perf_counter_t;
+
+static const char* const PERF_COUNTER_NAMES[PERF_COUNTER_COUNT] = {
+    "cycles", "instructions", "L1D-miss", "LLC-miss", "dTLB-miss", "br-miss"
+};
+
+typedef struct {
+    int leader;                         /* Group leader fd, -1 if none */
+    int fds[PERF_COUNTER_COUNT];        /* -1 when unavailable */
+    uint64_t ids[PERF_COUNTER_COUNT];   /* Kernel ids for matching group reads */
+    bool available[PERF_COUNTER_COUNT];
+    int open_count;
+} perf_counters_t;
+
+/* Accumulated counts for one class of timed region */
+typedef struct {
+    uint64_t regions;
+    uint64_t counts[PERF_COUNTER_COUNT];
+} perf_totals_t;
+
+#ifdef __linux__
+
+#define PERF_CACHE_CONFIG(cache, op, result) \
+    ((cache) | ((op) << 8) | ((result) << 16))
+
+static inline int perf_counters_open_one(uint32_t type, uint64_t config, int group_fd) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = (group_fd == -1);
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_ID;
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, 0);
+}
+
+/*
+ * Open and enable the counter group on the calling thread
+ *
+ * Returns: true if at least one counter is available
+ */
+static inline bool perf_counters_open(perf_counters_t* pc) {
+    static const struct { uint32_t type; uint64_t config; } events[PERF_COUNTER_COUNT] = {
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+        { PERF_TYPE_HW_CACHE, PERF_CACHE_CONFIG(PERF_COUNT_HW_CACHE_L1D,
+              PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_MISS) },
+        { PERF_TYPE_HW_CACHE, PERF_CACHE_CONFIG(PERF_COUNT_HW_CACHE_LL,
+              PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_MISS) },
+        { PERF_TYPE_HW_CACHE, PERF_CACHE_CONFIG(PERF_COUNT_HW_CACHE_DTLB,
+              PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_MISS) },
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+    };
+
+    memset(pc, 0, sizeof(*pc));
+    pc->leader = -1;
+    for (int i = 0; i < PERF_COUNTER_COUNT; i++) {
+        pc->fds[i] = perf_counters_open_one(events[i].type, events[i].config, pc->leader);
+        if (pc->fds[i] < 0) {
+            pc->fds[i] = -1;
+            continue;
+        }
+        if (ioctl(pc->fds[i], PERF_EVENT_IOC_ID, &pc->ids[i]) != 0) {
+            close(pc->fds[i]);
+            pc->fds[i] = -1;
+            continue;
+        }
+        if (pc->leader == -1) pc->leader = pc->fds[i];
+        pc->available[i] = true;
+        pc->open_count++;
+    }
+    if (pc->leader == -1) return false;
+
+    ioctl(pc->leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(pc->leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    return true;
+}
+
+/*
+ * Snapshot all counters (cumulative since open); unavailable ones read 0
+ *
+ * Returns: false if the group could not be read
+ */
+static inline bool perf_counters_read(const perf_counters_t* pc, uint64_t values[PERF_COUNTER_COUNT]) {
+    memset(values, 0, PERF_COUNTER_COUNT * sizeof(uint64_t));
+    if (pc->leader == -1) return false;
+
+    /* nr, then {value, id} per counter */
+    uint64_t buf[1 + 2 * PERF_COUNTER_COUNT];
+    ssize_t n = read(pc->leader, buf, sizeof(buf));
+    if (n < (ssize_t)sizeof(uint64_t)) return false;
+
+    for (uint64_t k = 0; k < buf[0] && k < PERF_COUNTER_COUNT; k++) {
+        for (int i = 0; i < PERF_COUNTER_COUNT; i++) {
+            if (pc->available[i] && pc->ids[i] == buf[2 + 2 * k]) {
+                values[i] = buf[1 + 2 * k];
+                break;
+            }
+        }
+    }
+    return true;
+}
+
+static inline void perf_counters_close(perf_counters_t* pc) {
+    for (int i = 0; i < PERF_COUNTER_COUNT; i++) {
+        if (pc->fds[i] >= 0 && pc->fds[i] != pc->leader) close(pc->fds[i]);
+    }
+    if (pc->leader >= 0) close(pc->leader);
+    memset(pc, 0, sizeof(*pc));
+    pc->leader = -1;
+}
+
+#else /* !__linux__ */
+
+static inline bool perf_counters_open(perf_counters_t* pc) {
+    memset(pc, 0, sizeof(*pc));
+    pc->leader = -1;
+    return false;
+}
+
+static inline bool perf_counters_read(const perf_counters_t* pc, uint64_t values[PERF_COUNTER_COUNT]) {
+    (void)pc;
+    memset(values, 0, PERF_COUNTER_COUNT * sizeof(uint64_t));
+    return false;
+}
+
+static inline void perf_counters_close(perf_counters_t* pc) {
+    (void)pc;
+}
+
+#endif /* __linux__ */
+
+/* Add the difference between two snapshots to a running total */
+static inline void perf_totals_add(perf_totals_t* totals, const uint64_t before[PERF_COUNTER_COUNT],
+                                   const uint64_t after[PERF_COUNTER_COUNT]) {
+    totals->regions++;
+    for (int i = 0; i < PERF_COUNTER_COUNT; i++) {
+        totals->counts[i] += after[i] - before[i];
+    }
+}
+
+/* Print per-region averages, "n/a" for counters that are unavailable */
+static inline void perf_totals_print(const perf_counters_t* pc, const char* label,
+                                     const perf_totals_t* totals, FILE* out) {
+    fprintf(out, "%-10s %10llu", label, (unsigned long long)totals->regions);
+    for (int i = 0; i < PERF_COUNTER_COUNT; i++) {
+        if (!pc->available[i] || totals->regions == 0) {
+            fprintf(out, " %12s", "n/a");
+        } else {
+            fprintf(out, " %12.1f", (double)totals->counts[i] / (double)totals->regions);
+        }
+    }
+    if (pc->available[PERF_COUNTER_CYCLES] && pc->available[PERF_COUNTER_INSTRUCTIONS] &&
+        totals->counts[PERF_COUNTER_CYCLES] > 0) {
+        fprintf(out, " %6.2f", (double)totals->counts[PERF_COUNTER_INSTRUCTIONS] /
+                               (double)totals->counts[PERF_COUNTER_CYCLES]);
+    } else {
+        fprintf(out, " %6s", "n/a");
+    }
+    fprintf(out, "\n");
+}
+
+/* Column header matching perf_totals_print() */
+static inline void perf_totals_print_header(FILE* out) {
+    fprintf(out, "%-10s %10s", "", "regions");
+    for (int i = 0; i < PERF_COUNTER_COUNT; i++) {
+        fprintf(out, " %12s", PERF_COUNTER_NAMES[i]);
+    }
+    fprintf(out, " %6s\n", "IPC");
+}
+
+#endif /* PERF_COUNTERS_H */
@@ -0,0 +1,132 @@
+/*
+ * probestats_symspell.c - Probe-length and clustering report for the hash
+ * tables.
+ *
+ * Loads a dictionary and walks the delete table and the exact-match table
+ * (xxh3, linear probing modulo a prime), then builds a hash.h table
+ * (FNV-1a, power-of-two mask) over the same words. For each table it prints
+ * occupancy, cluster sizes, probe-length histograms for successful and
+ * unsuccessful searches and the expected cold-cache misses per lookup.
+ */
+
+#define _GNU_SOURCE
+#define _POSIX_C_SOURCE 200809L
+
+#include "symspell.h"
+#include "hash.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_LINE_BUFFER 8192
+#define EDIT_DISTANCE 2
+#define PREFIX_LENGTH 7
+
+static void print_histogram(const char* label, const uint64_t* histogram, size_t buckets,
+                            uint64_t total) {
+    printf("  %s probe histogram:\n", label);
+    uint64_t cumulative = 0;
+    for (size_t k = 0; k < buckets; k++) {
+        if (histogram[k] == 0) continue;
+        cumulative += histogram[k];
+        printf("    %3zu%s %12llu  %6.2f%%  (cum %6.2f%%)\n", k + 1,
+               (k == buckets - 1) ? "+" : " ",
+               (unsigned long long)histogram[k],
+               total ? 100.0 * (double)histogram[k] / (double)total : 0.0,
+               total ? 100.0 * (double)cumulative / (double)total : 0.0);
+    }
+}
+
+static void print_table_stats(const char* name, const symspell_table_stats_t* st) {
+    printf("=== %s ===\n", name);
+    printf("  Slots:             %zu\n", st->slots);
+    printf("  Occupied:          %zu (load %.1f%%)\n", st->occupied, 100.0 * st->load_factor);
+    printf("  Clusters:          %zu (mean %.2f, longest %zu)\n",
+           st->clusters, st->mean_cluster, st->longest_cluster);
+    printf("  Probes (hit):      mean %.3f, max %zu\n", st->mean_hit_probes, st->max_hit_probes);
+    printf("  Probes (miss):     mean %.3f, max %zu\n", st->mean_miss_probes, st->max_miss_probes);
+    printf("  Expected misses:   %.3f per hit, %.3f per miss (cold cache)\n",
+           st->expected_hit_misses, st->expected_miss_misses);
+    print_histogram("Hit", st->hit_probes, SYMSPELL_PROBE_HISTOGRAM_SIZE, st->occupied);
+    print_histogram("Miss", st->miss_probes, SYMSPELL_PROBE_HISTOGRAM_SIZE, st->slots);
+    printf("\n");
+}
+
+/* Build a hash.h table over the dictionary words and report on it */
+static int report_ht_table(const char* filepath) {
+    FILE* fp = fopen(filepath, "r");
+    if (!fp) {
+        fprintf(stderr, "Failed to open dictionary: %s\n", filepath);
+        return 1;
+    }
+
+    HT_TABLE* table = ht_create(0);
+    if (!table) {
+        fclose(fp);
+        return 1;
+    }
+
+    char line[MAX_LINE_BUFFER];
+    while (fgets(line, sizeof(line), fp)) {
+        char* word = strtok(line, " \t\r\n");
+        if (!word) continue;
+        char* key = strdup(word);
+        if (!key) break;
+        HT_ENTRY find = {key, NULL};
+        if (ht_search(table, find, HT_FIND)) {
+            free(key);
+            continue;
+        }
+        HT_ENTRY item = {key, NULL};
+        ht_search(table, item, HT_ENTER);
+    }
+    fclose(fp);
+
+    HT_STATS st;
+    ht_stats(table, &st);
+
+    printf("=== hash.h table (dictionary words, FNV-1a) ===\n");
+    printf("  Slots:             %zu\n", st.size);
+    printf("  Occupied:          %zu (load %.1f%%)\n", st.count, 100.0 * st.load_factor);
+    printf("  Clusters:          %zu (longest %zu)\n", st.clusters, st.longest_cluster);
+    printf("  Probes (hit):      mean %.3f, max %zu\n", st.mean_hit_probes, st.max_hit_probes);
+    printf("  Probes (miss):     mean %.3f, max %zu\n", st.mean_miss_probes, st.max_miss_probes);
+    printf("  Expected misses:   %.3f per hit, %.3f per miss (cold cache)\n",
+           st.expected_hit_misses, st.expected_miss_misses);
+    print_histogram("Hit", st.hit_probes, HT_STATS_HISTOGRAM_SIZE, st.count);
+    print_histogram("Miss", st.miss_probes, HT_STATS_HISTOGRAM_SIZE, st.size);
+    printf("\n");
+
+    ht_destroy_free_keys(table);
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s <dictionary_file> [max_edit_distance] [prefix_length]\n", argv[0]);
+        return 1;
+    }
+
+    int max_edit_distance = (argc > 2) ? atoi(argv[2]) : EDIT_DISTANCE;
+    int prefix_length = (argc > 3) ? atoi(argv[3]) : PREFIX_LENGTH;
+
+    symspell_dict_t* dict = symspell_create(max_edit_distance, prefix_length);
+    if (!dict || !symspell_load_dictionary(dict, argv[1], 0, 1)) {
+        fprintf(stderr, "Failed to load dictionary\n");
+        if (dict) symspell_destroy(dict);
+        return 1;
+    }
+    printf("\nDictionary: %s (max_edit_distance=%d, prefix_length=%d)\n\n",
+           argv[1], max_edit_distance, prefix_length);
+
+    symspell_table_stats_t st;
+    if (symspell_get_table_stats(dict, SYMSPELL_TABLE_DELETES, &st)) {
+        print_table_stats("Delete table (xxh3, prime modulo)", &st);
+    }
+    if (symspell_get_table_stats(dict, SYMSPELL_TABLE_EXACT, &st)) {
+        print_table_stats("Exact-match table (xxh3, prime modulo)", &st);
+    }
+    symspell_destroy(dict);
+
+    return report_ht_table(argv[1]);
+}
@@ -0,0 +1,289 @@
+/*
+ * replay_symspell.c - Capture and replay query traces.
+ *
+ * record: runs a misspelling file (misspelled<TAB>expected per line) through
+ *         symspell_lookup() with the trace hook installed, producing a trace
+ *         in the same format production captures use.
+ * replay: runs every lookup of a trace against a dictionary build, either
+ *         closed-loop (back to back, maximum rate) or open-loop (each lookup
+ *         issued at its recorded offset from the first), then compares the
+ *         latency distribution and the results with what was recorded.
+ */
+
+#define _GNU_SOURCE
+#define _POSIX_C_SOURCE 200809L
+
+#include "symspell.h"
+#include "symspell_trace.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+
+#define SYMSPELL_MAX_TERM_LENGTH 128
+#define MAX_LINE_BUFFER 8192
+#define EDIT_DISTANCE 2
+#define PREFIX_LENGTH 7
+#define MAX_SUGGESTIONS 5
+#define REPLAY_MAX_SUGGESTIONS 64
+#define INITIAL_SAMPLE_CAPACITY 4096
+#define DIFF_FILE "replay-diffs.txt"
+
+/* Monotonic clock in nanoseconds */
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void sleep_until_ns(uint64_t deadline_ns) {
+    struct timespec ts;
+    ts.tv_sec = (time_t)(deadline_ns / 1000000000ULL);
+    ts.tv_nsec = (long)(deadline_ns % 1000000000ULL);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR) {
+    }
+}
+
+static int compare_u64(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a;
+    uint64_t y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+/* Nearest-rank percentile of a sorted sample, in microseconds */
+static double percentile_us(const uint64_t* sorted, size_t n, double p) {
+    if (n == 0) return 0.0;
+    size_t rank = (size_t)(p / 100.0 * (double)n);
+    if (rank >= n) rank = n - 1;
+    return (double)sorted[rank] / 1000.0;
+}
+
+static void print_distribution_row(const char* label, uint64_t* samples, size_t n) {
+    qsort(samples, n, sizeof(uint64_t), compare_u64);
+    double sum = 0;
+    for (size_t i = 0; i < n; i++) sum += (double)samples[i];
+    printf("%-10s %10.1f %10.1f %10.1f %10.1f %10.1f %10.1f\n", label,
+           n ? sum / (double)n / 1000.0 : 0.0,
+           percentile_us(samples, n, 50.0),
+           percentile_us(samples, n, 90.0),
+           percentile_us(samples, n, 99.0),
+           percentile_us(samples, n, 99.9),
+           n ? (double)samples[n - 1] / 1000.0 : 0.0);
+}
+
+static symspell_dict_t* load_dictionary(const char* filepath) {
+    symspell_dict_t* dict = symspell_create(EDIT_DISTANCE, PREFIX_LENGTH);
+    if (!dict || !symspell_load_dictionary(dict, filepath, 0, 1)) {
+        fprintf(stderr, "Failed to load dictionary\n");
+        if (dict) symspell_destroy(dict);
+        return NULL;
+    }
+    return dict;
+}
+
+static int cmd_record(const char* dict_path, const char* test_path, const char* trace_path) {
+    symspell_dict_t* dict = load_dictionary(dict_path);
+    if (!dict) return 1;
+
+    FILE* fp = fopen(test_path, "r");
+    if (!fp) {
+        fprintf(stderr, "Failed to open test file: %s\n", test_path);
+        symspell_destroy(dict);
+        return 1;
+    }
+
+    symspell_trace_writer_t* writer = symspell_trace_writer_open(trace_path);
+    if (!writer) {
+        fclose(fp);
+        symspell_destroy(dict);
+        return 1;
+    }
+    symspell_set_lookup_hook(dict, symspell_trace_hook, writer);
+
+    char line[MAX_LINE_BUFFER];
+    while (fgets(line, sizeof(line), fp)) {
+        char misspelled[SYMSPELL_MAX_TERM_LENGTH], expected[SYMSPELL_MAX_TERM_LENGTH];
+        if (sscanf(line, "%127s\t%127s", misspelled, expected) != 2) continue;
+
+        symspell_suggestion_t suggestions[MAX_SUGGESTIONS];
+        symspell_lookup(dict, misspelled, EDIT_DISTANCE, suggestions, MAX_SUGGESTIONS);
+    }
+
+    symspell_set_lookup_hook(dict, NULL, NULL);
+    uint64_t records = symspell_trace_writer_close(writer);
+    printf("Recorded %llu lookups to %s\n", (unsigned long long)records, trace_path);
+
+    fclose(fp);
+    symspell_destroy(dict);
+    return 0;
+}
+
+/* Growable array of latency samples */
+typedef struct {
+    uint64_t* data;
+    size_t count;
+    size_t capacity;
+} sample_vec_t;
+
+static bool sample_push(sample_vec_t* v, uint64_t value) {
+    if (v->count == v->capacity) {
+        size_t new_cap = v->capacity ? v->capacity * 2 : INITIAL_SAMPLE_CAPACITY;
+        uint64_t* new_data = realloc(v->data, new_cap * sizeof(uint64_t));
+        if (!new_data) return false;
+        v->data = new_data;
+        v->capacity = new_cap;
+    }
+    v->data[v->count++] = value;
+    return true;
+}
+
+/* True when the replayed result matches what the trace recorded */
+static bool same_results(const symspell_trace_record_t* rec,
+                         const symspell_suggestion_t* got, int count) {
+    if (count != rec->result_count) return false;
+    for (int i = 0; i < rec->stored_count && i < count; i++) {
+        if (strcmp(rec->results[i].term, got[i].term) != 0 ||
+            rec->results[i].distance != got[i].distance ||
+            rec->results[i].frequency != got[i].frequency) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static int cmd_replay(const char* dict_path, const char* trace_path, bool open_loop) {
+    symspell_trace_reader_t* reader = symspell_trace_reader_open(trace_path);
+    if (!reader) {
+        fprintf(stderr, "Failed to open trace: %s\n", trace_path);
+        return 1;
+    }
+
+    symspell_dict_t* dict = load_dictionary(dict_path);
+    if (!dict) {
+        symspell_trace_reader_close(reader);
+        return 1;
+    }
+
+    FILE* diffs_fp = fopen(DIFF_FILE, "w");
+    if (!diffs_fp) {
+        fprintf(stderr, "Failed to open %s for writing\n", DIFF_FILE);
+        symspell_trace_reader_close(reader);
+        symspell_destroy(dict);
+        return 1;
+    }
+
+    printf("Replaying %s (%s)\n", trace_path, open_loop ? "open-loop" : "closed-loop");
+
+    sample_vec_t recorded = {0}, replayed = {0};
+    size_t total = 0, differences = 0, late = 0;
+    uint64_t max_lag_ns = 0;
+    uint64_t first_ts = 0, replay_start = 0;
+
+    symspell_trace_record_t rec;
+    while (symspell_trace_read(reader, &rec)) {
+        if (total == 0) {
+            first_ts = rec.timestamp_ns;
+            replay_start = now_ns();
+        }
+        total++;
+
+        if (open_loop && rec.timestamp_ns > first_ts) {
+            uint64_t due = replay_start + (rec.timestamp_ns - first_ts);
+            uint64_t now = now_ns();
+            if (now < due) {
+                sleep_until_ns(due);
+            } else if (now > due) {
+                late++;
+                if (now - due > max_lag_ns) max_lag_ns = now - due;
+            }
+        }
+
+        int max_suggestions = rec.max_suggestions;
+        if (max_suggestions < 1) max_suggestions = 1;
+        if (max_suggestions > REPLAY_MAX_SUGGESTIONS) max_suggestions = REPLAY_MAX_SUGGESTIONS;
+
+        symspell_suggestion_t suggestions[REPLAY_MAX_SUGGESTIONS];
+        uint64_t start = now_ns();
+        int count = symspell_lookup(dict, rec.term, rec.max_edit_distance,
+                                    suggestions, max_suggestions);
+        uint64_t elapsed = now_ns() - start;
+
+        if (!sample_push(&recorded, rec.latency_ns) || !sample_push(&replayed, elapsed)) {
+            fprintf(stderr, "Out of memory\n");
+            break;
+        }
+
+        if (!same_results(&rec, suggestions, count)) {
+            differences++;
+            fprintf(diffs_fp, "%s\t%s\t%s\n", rec.term,
+                    rec.stored_count > 0 ? rec.results[0].term : "(none)",
+                    count > 0 ? suggestions[0].term : "(none)");
+        }
+
+        if (total % 1000 == 0) {
+            fprintf(stderr, "\rReplayed: %zu...", total);
+            fflush(stderr);
+        }
+    }
+    fprintf(stderr, "\rReplayed: %zu... Done.\n\n", total);
+
+    printf("--- Latency (µs) ---\n");
+    printf("%-10s %10s %10s %10s %10s %10s %10s\n",
+           "", "mean", "p50", "p90", "p99", "p99.9", "max");
+    print_distribution_row("recorded", recorded.data, recorded.count);
+    print_distribution_row("replayed", replayed.data, replayed.count);
+    if (recorded.count > 0) {
+        double rec_p50 = percentile_us(recorded.data, recorded.count, 50.0);
+        double rep_p50 = percentile_us(replayed.data, replayed.count, 50.0);
+        double rec_p99 = percentile_us(recorded.data, recorded.count, 99.0);
+        double rep_p99 = percentile_us(replayed.data, replayed.count, 99.0);
+        printf("change     p50 %+.1f%%, p99 %+.1f%%\n",
+               rec_p50 > 0 ? 100.0 * (rep_p50 - rec_p50) / rec_p50 : 0.0,
+               rec_p99 > 0 ? 100.0 * (rep_p99 - rec_p99) / rec_p99 : 0.0);
+    }
+    if (open_loop) {
+        printf("Late starts: %zu (max lag %.1f µs)\n", late, (double)max_lag_ns / 1000.0);
+    }
+
+    printf("\n--- Result Differences ---\n");
+    printf("Lookups replayed: %zu\n", total);
+    printf("Different results: %zu (%.2f%%)\n", differences,
+           total ? 100.0 * (double)differences / (double)total : 0.0);
+    printf("\nDifferences written to %s (term, recorded, replayed)\n", DIFF_FILE);
+
+    free(recorded.data);
+    free(replayed.data);
+    fclose(diffs_fp);
+    symspell_trace_reader_close(reader);
+    symspell_destroy(dict);
+    return 0;
+}
+
+static void usage(const char* prog) {
+    fprintf(stderr, "Usage:\n");
+    fprintf(stderr, "  %s record <dictionary_file> <test_file> <trace_file>\n", prog);
+    fprintf(stderr, "  %s replay <dictionary_file> <trace_file> [--open-loop|--closed-loop]\n", prog);
+}
+
+int main(int argc, char* argv[]) {
+    if (argc >= 5 && strcmp(argv[1], "record") == 0) {
+        return cmd_record(argv[2], argv[3], argv[4]);
+    }
+    if (argc >= 4 && strcmp(argv[1], "replay") == 0) {
+        bool open_loop = false;
+        for (int i = 4; i < argc; i++) {
+            if (strcmp(argv[i], "--open-loop") == 0) {
+                open_loop = true;
+            } else if (strcmp(argv[i], "--closed-loop") == 0) {
+                open_loop = false;
+            } else {
+                usage(argv[0]);
+                return 1;
+            }
+        }
+        return cmd_replay(argv[2], argv[3], open_loop);
+    }
+    usage(argv[0]);
+    return 1;
+}
@@ -0,0 +1,354 @@
+/*
+ * sweep_symspell.c - Accuracy/latency/memory sweep over build parameters.
+ *
+ * Builds a dictionary for every combination of max_edit_distance,
+ * prefix_length and dictionary file, runs all misspelling corpora against
+ * it and records accuracy, p50/p99 lookup latency, load time and memory.
+ * Each combination runs in its own child process so memory figures are not
+ * polluted by earlier builds and a configuration that exhausts an arena
+ * cannot take the sweep down. Finally the Pareto frontier over (accuracy,
+ * p99 latency, memory) is printed so settings can be picked per deployment
+ * tier.
+ */
+
+#define _GNU_SOURCE
+#define _POSIX_C_SOURCE 200809L
+
+#include "symspell.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+
+#define SYMSPELL_MAX_TERM_LENGTH 128
+#define MAX_LINE_BUFFER 8192
+#define MAX_GRID_VALUES 8
+#define MAX_DICTIONARIES 8
+#define MAX_CONFIGS (MAX_GRID_VALUES * MAX_GRID_VALUES * MAX_DICTIONARIES)
+#define MAX_SUGGESTIONS 5
+#define CORPUS_COUNT 4
+#define DEFAULT_CORPUS_DIR "test/data/symspell/misspellings"
+#define DEFAULT_DICTIONARY "dictionaries/dictionary.txt"
+#define DEFAULT_CSV "sweep.csv"
+
+static const char* CORPUS_FILES[CORPUS_COUNT] = {
+    "misspell-codespell.txt",
+    "misspell-wikipedia.txt",
+    "misspell-microsoft.txt",
+    "misspell-words.go.txt",
+};
+
+/* Result of one configuration, sent from the child over a pipe */
+typedef struct {
+    int ok;
+    int max_edit_distance;
+    int prefix_length;
+    int dict_index;
+    size_t words;
+    size_t deletes;
+    double load_ms;
+    double rss_mb;                      /* Resident set growth from load */
+    double accuracy[CORPUS_COUNT];      /* Per corpus, percent */
+    double mean_accuracy;               /* Unweighted mean over corpora */
+    double p50_us;
+    double p99_us;
+    long lookups;
+    int pareto;
+} sweep_result_t;
+
+static double get_time_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1000.0 + (double)ts.tv_nsec / 1000000.0;
+}
+
+/* Resident set size in MB (Linux /proc, falling back to peak RSS) */
+static double resident_mb(void) {
+    FILE* fp = fopen("/proc/self/statm", "r");
+    if (fp) {
+        long size, resident;
+        int n = fscanf(fp, "%ld %ld", &size, &resident);
+        fclose(fp);
+        if (n == 2) return (double)resident * (double)sysconf(_SC_PAGESIZE) / (1024.0 * 1024.0);
+    }
+    struct rusage ru;
+    getrusage(RUSAGE_SELF, &ru);
+    return (double)ru.ru_maxrss / 1024.0;
+}
+
+static int compare_double(const void* a, const void* b) {
+    double x = *(const double*)a;
+    double y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+static int parse_int_list(const char* arg, int* out, int max) {
+    int n = 0;
+    char* copy = strdup(arg);
+    if (!copy) return 0;
+    for (char* tok = strtok(copy, ","); tok && n < max; tok = strtok(NULL, ",")) {
+        out[n++] = atoi(tok);
+    }
+    free(copy);
+    return n;
+}
+
+/* Build one configuration and run every corpus against it (child process) */
+static void run_config(sweep_result_t* r, const char* dict_path, const char* corpus_dir,
+                       long limit) {
+    double rss_before = resident_mb();
+    double start = get_time_ms();
+    symspell_dict_t* dict = symspell_create(r->max_edit_distance, r->prefix_length);
+    if (!dict || !symspell_load_dictionary(dict, dict_path, 0, 1)) {
+        if (dict) symspell_destroy(dict);
+        return;
+    }
+    r->load_ms = get_time_ms() - start;
+    r->rss_mb = resident_mb() - rss_before;
+    symspell_get_stats(dict, &r->words, &r->deletes);
+
+    size_t capacity = 1 << 16;
+    size_t count = 0;
+    double* latencies = malloc(capacity * sizeof(double));
+    if (!latencies) {
+        symspell_destroy(dict);
+        return;
+    }
+
+    double accuracy_sum = 0;
+    for (int c = 0; c < CORPUS_COUNT; c++) {
+        char path[MAX_LINE_BUFFER];
+        snprintf(path, sizeof(path), "%s/%s", corpus_dir, CORPUS_FILES[c]);
+        FILE* fp = fopen(path, "r");
+        if (!fp) continue;
+
+        long total = 0, correct = 0;
+        char line[MAX_LINE_BUFFER];
+        while (fgets(line, sizeof(line), fp) && (limit <= 0 || total < limit)) {
+            char misspelled[SYMSPELL_MAX_TERM_LENGTH], expected[SYMSPELL_MAX_TERM_LENGTH];
+            if (sscanf(line, "%127s\t%127s", misspelled, expected) != 2) continue;
+            total++;
+
+            symspell_suggestion_t suggestions[MAX_SUGGESTIONS];
+            double t0 = get_time_ms();
+            int n = symspell_lookup(dict, misspelled, r->max_edit_distance,
+                                    suggestions, MAX_SUGGESTIONS);
+            double elapsed_us = (get_time_ms() - t0) * 1000.0;
+
+            if (n > 0 && strcmp(suggestions[0].term, expected) == 0) correct++;
+
+            if (count == capacity) {
+                double* grown = realloc(latencies, capacity * 2 * sizeof(double));
+                if (!grown) break;
+                latencies = grown;
+                capacity *= 2;
+            }
+            latencies[count++] = elapsed_us;
+        }
+        fclose(fp);
+
+        r->accuracy[c] = total ? 100.0 * (double)correct / (double)total : 0.0;
+        accuracy_sum += r->accuracy[c];
+    }
+    r->mean_accuracy = accuracy_sum / CORPUS_COUNT;
+
+    qsort(latencies, count, sizeof(double), compare_double);
+    if (count > 0) {
+        r->p50_us = latencies[(size_t)(0.50 * (double)count)];
+        r->p99_us = latencies[(size_t)(0.99 * (double)count)];
+    }
+    r->lookups = (long)count;
+    r->ok = 1;
+
+    free(latencies);
+    symspell_destroy(dict);
+}
+
+/* Fork, run the configuration in the child, read its result back */
+static void run_isolated(sweep_result_t* r, const char* dict_path, const char* corpus_dir,
+                         long limit) {
+    int fds[2];
+    if (pipe(fds) != 0) {
+        perror("pipe");
+        return;
+    }
+
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid < 0) {
+        perror("fork");
+        close(fds[0]);
+        close(fds[1]);
+        return;
+    }
+
+    if (pid == 0) {
+        close(fds[0]);
+        /* Keep the loader's progress output out of the report */
+        if (!freopen("/dev/null", "w", stdout) || !freopen("/dev/null", "w", stderr)) _exit(1);
+        run_config(r, dict_path, corpus_dir, limit);
+        ssize_t written = write(fds[1], r, sizeof(*r));
+        _exit(written == (ssize_t)sizeof(*r) ? 0 : 1);
+    }
+
+    close(fds[1]);
+    sweep_result_t child;
+    if (read(fds[0], &child, sizeof(child)) == (ssize_t)sizeof(child)) {
+        *r = child;
+    }
+    close(fds[0]);
+    waitpid(pid, NULL, 0);
+}
+
+/* a dominates b: at least as good everywhere and strictly better somewhere */
+static int dominates(const sweep_result_t* a, const sweep_result_t* b) {
+    if (a->mean_accuracy < b->mean_accuracy || a->p99_us > b->p99_us || a->rss_mb > b->rss_mb) {
+        return 0;
+    }
+    return a->mean_accuracy > b->mean_accuracy || a->p99_us < b->p99_us || a->rss_mb < b->rss_mb;
+}
+
+static int compare_by_memory(const void* a, const void* b) {
+    const sweep_result_t* x = a;
+    const sweep_result_t* y = b;
+    return (x->rss_mb > y->rss_mb) - (x->rss_mb < y->rss_mb);
+}
+
+static void usage(const char* prog) {
+    fprintf(stderr, "Usage: %s [options]\n", prog);
+    fprintf(stderr, "  --distances LIST   max_edit_distance values (default 1,2)\n");
+    fprintf(stderr, "  --prefixes LIST    prefix_length values (default 5,6,7)\n");
+    fprintf(stderr, "  --dict FILE        dictionary to sweep (repeatable, default %s)\n", DEFAULT_DICTIONARY);
+    fprintf(stderr, "  --corpora DIR      misspelling corpora directory (default %s)\n", DEFAULT_CORPUS_DIR);
+    fprintf(stderr, "  --limit N          lookups per corpus (default: all)\n");
+    fprintf(stderr, "  --csv FILE         CSV output (default %s)\n", DEFAULT_CSV);
+}
+
+int main(int argc, char* argv[]) {
+    int distances[MAX_GRID_VALUES] = {1, 2};
+    int distance_count = 2;
+    int prefixes[MAX_GRID_VALUES] = {5, 6, 7};
+    int prefix_count = 3;
+    const char* dicts[MAX_DICTIONARIES];
+    int dict_count = 0;
+    const char* corpus_dir = DEFAULT_CORPUS_DIR;
+    const char* csv_path = DEFAULT_CSV;
+    long limit = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (i + 1 >= argc) {
+            usage(argv[0]);
+            return 1;
+        }
+        if (strcmp(argv[i], "--distances") == 0) {
+            distance_count = parse_int_list(argv[++i], distances, MAX_GRID_VALUES);
+        } else if (strcmp(argv[i], "--prefixes") == 0) {
+            prefix_count = parse_int_list(argv[++i], prefixes, MAX_GRID_VALUES);
+        } else if (strcmp(argv[i], "--dict") == 0) {
+            if (dict_count < MAX_DICTIONARIES) dicts[dict_count++] = argv[++i];
+            else i++;
+        } else if (strcmp(argv[i], "--corpora") == 0) {
+            corpus_dir = argv[++i];
+        } else if (strcmp(argv[i], "--limit") == 0) {
+            limit = atol(argv[++i]);
+        } else if (strcmp(argv[i], "--csv") == 0) {
+            csv_path = argv[++i];
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (dict_count == 0) dicts[dict_count++] = DEFAULT_DICTIONARY;
+
+    for (int c = 0; c < CORPUS_COUNT; c++) {
+        char path[MAX_LINE_BUFFER];
+        snprintf(path, sizeof(path), "%s/%s", corpus_dir, CORPUS_FILES[c]);
+        FILE* fp = fopen(path, "r");
+        if (!fp) {
+            fprintf(stderr, "Warning: corpus not found: %s\n", path);
+            continue;
+        }
+        fclose(fp);
+    }
+
+    static sweep_result_t results[MAX_CONFIGS];
+    int n = 0;
+    for (int d = 0; d < dict_count; d++) {
+        for (int e = 0; e < distance_count; e++) {
+            for (int p = 0; p < prefix_count; p++) {
+                sweep_result_t* r = &results[n++];
+                memset(r, 0, sizeof(*r));
+                r->dict_index = d;
+                r->max_edit_distance = distances[e];
+                r->prefix_length = prefixes[p];
+                fprintf(stderr, "[%d/%d] %s d=%d p=%d ...\n", n,
+                        dict_count * distance_count * prefix_count,
+                        dicts[d], distances[e], prefixes[p]);
+                run_isolated(r, dicts[d], corpus_dir, limit);
+            }
+        }
+    }
+
+    /* Pareto frontier: maximize accuracy, minimize p99 latency and memory */
+    for (int i = 0; i < n; i++) {
+        if (!results[i].ok) continue;
+        results[i].pareto = 1;
+        for (int j = 0; j < n && results[i].pareto; j++) {
+            if (j != i && results[j].ok && dominates(&results[j], &results[i])) {
+                results[i].pareto = 0;
+            }
+        }
+    }
+
+    FILE* csv = fopen(csv_path, "w");
+    if (csv) {
+        fprintf(csv, "dictionary,max_edit_distance,prefix_length,words,deletes,load_ms,rss_mb,"
+                     "codespell,wikipedia,microsoft,words_go,mean_accuracy,p50_us,p99_us,lookups,pareto\n");
+    }
+
+    printf("%-3s %-32s %2s %2s %9s %9s %8s %7s %7s %7s %7s %7s %8s %8s\n",
+           "", "dictionary", "d", "p", "deletes", "load_ms", "rss_mb",
+           "codesp", "wiki", "msft", "wordsgo", "mean", "p50_us", "p99_us");
+    for (int i = 0; i < n; i++) {
+        const sweep_result_t* r = &results[i];
+        if (!r->ok) {
+            printf("    %-32s %2d %2d   FAILED (load error or arena exhausted)\n",
+                   dicts[r->dict_index], r->max_edit_distance, r->prefix_length);
+            continue;
+        }
+        printf("%-3s %-32s %2d %2d %9zu %9.1f %8.1f %6.1f%% %6.1f%% %6.1f%% %6.1f%% %6.1f%% %8.1f %8.1f\n",
+               r->pareto ? "*" : "", dicts[r->dict_index], r->max_edit_distance, r->prefix_length,
+               r->deletes, r->load_ms, r->rss_mb, r->accuracy[0], r->accuracy[1],
+               r->accuracy[2], r->accuracy[3], r->mean_accuracy, r->p50_us, r->p99_us);
+        if (csv) {
+            fprintf(csv, "%s,%d,%d,%zu,%zu,%.1f,%.1f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%ld,%d\n",
+                    dicts[r->dict_index], r->max_edit_distance, r->prefix_length, r->words,
+                    r->deletes, r->load_ms, r->rss_mb, r->accuracy[0], r->accuracy[1],
+                    r->accuracy[2], r->accuracy[3], r->mean_accuracy, r->p50_us, r->p99_us,
+                    r->lookups, r->pareto);
+        }
+    }
+    if (csv) fclose(csv);
+
+    /* Frontier ordered by memory: one row per deployment tier candidate */
+    sweep_result_t frontier[MAX_CONFIGS];
+    int f = 0;
+    for (int i = 0; i < n; i++) {
+        if (results[i].ok && results[i].pareto) frontier[f++] = results[i];
+    }
+    qsort(frontier, f, sizeof(sweep_result_t), compare_by_memory);
+
+    printf("\n--- Pareto frontier (accuracy vs p99 latency vs memory) ---\n");
+    for (int i = 0; i < f; i++) {
+        printf("  %6.1f MB  p99 %8.1f µs  accuracy %5.1f%%  %s d=%d p=%d\n",
+               frontier[i].rss_mb, frontier[i].p99_us, frontier[i].mean_accuracy,
+               dicts[frontier[i].dict_index], frontier[i].max_edit_distance,
+               frontier[i].prefix_length);
+    }
+    printf("\nFull results written to %s\n", csv_path);
+    return 0;
+}
@@ -10,14 +10,33 @@
 #define MAX_SUGGESTIONS 5
 #define PREFIX_LENGTH 7
 
+/* Plain lookup, or with --explain a traced one whose trace is printed */
+static int lookup_word(const symspell_dict_t* dict, const char* word,
+                       symspell_suggestion_t* suggestions, bool explain_mode) {
+    if (!explain_mode) {
+        return symspell_lookup(dict, word, MAX_EDIT_DISTANCE, suggestions, MAX_SUGGESTIONS);
+    }
+    symspell_explain_t explain;
+    int count = symspell_lookup_explain(dict, word, MAX_EDIT_DISTANCE, suggestions,
+                                        MAX_SUGGESTIONS, &explain);
+    symspell_explain_print(&explain, stdout);
+    symspell_explain_free(&explain);
+    return count;
+}
+
 int main(int argc, char* argv[]) {
     if (argc < 2) {
-        fprintf(stderr, "Usage: %s <dictionary_file> [word expected word expected ...]\n", argv[0]);
+        fprintf(stderr, "Usage: %s <dictionary_file> [--explain] [word expected word expected ...]\n", argv[0]);
         fprintf(stderr, "\nExamples:\n");
         fprintf(stderr, "  Interactive: %s dictionaries/dictionary.txt\n", argv[0]);
+        fprintf(stderr, "  Explain:     %s dictionaries/dictionary.txt --explain\n", argv[0]);
         fprintf(stderr, "  Batch test:  %s dictionaries/dictionary.txt helo hello recieve receive\n", argv[0]);
         return 1;
     }
+
+    /* --explain prints the lookup trace for every word */
+    bool explain_mode = (argc > 2 && strcmp(argv[2], "--explain") == 0);
+    int first_arg = explain_mode ? 3 : 2;
     
     printf("Creating SymSpell dictionary...\n");
     symspell_dict_t* dict = symspell_create(MAX_EDIT_DISTANCE, PREFIX_LENGTH);
@@ -38,12 +57,12 @@ int main(int argc, char* argv[]) {
     printf("Loaded %zu words, %zu delete entries\n\n", word_count, entry_count);
     
     /* Batch test mode: pairs of (misspelled, expected) */
-    if (argc > 2) {
+    if (argc > first_arg) {
         printf("=== Batch Test Mode ===\n");
         int tests = 0;
         int passed = 0;
         
-        for (int i = 2; i < argc; i += 2) {
+        for (int i = first_arg; i < argc; i += 2) {
             if (i + 1 >= argc) {
                 fprintf(stderr, "Warning: Odd number of test arguments, ignoring '%s'\n", argv[i]);
                 break;
@@ -53,7 +72,7 @@ int main(int argc, char* argv[]) {
             const char* expected = argv[i + 1];
             
             symspell_suggestion_t suggestions[MAX_SUGGESTIONS];
-            int count = symspell_lookup(dict, input, MAX_EDIT_DISTANCE, suggestions, MAX_SUGGESTIONS);
+            int count = lookup_word(dict, input, suggestions, explain_mode);
             
             tests++;
             
@@ -90,7 +109,7 @@ int main(int argc, char* argv[]) {
         if (strlen(line) == 0) continue;
         
         symspell_suggestion_t suggestions[MAX_SUGGESTIONS];
-        int count = symspell_lookup(dict, line, MAX_EDIT_DISTANCE, suggestions, MAX_SUGGESTIONS);
+        int count = lookup_word(dict, line, suggestions, explain_mode);
         
         if (count == 0) {
             printf("  No suggestions\n");
@@ -0,0 +1,359 @@
+/*
+ * torture_symspell.c - Worst-case latency suite.
+ *
+ * Generates (or reads) an adversarial query corpus and times every query
+ * against a dictionary. Categories:
+ *
+ *   long       127-byte tokens, random letters and glued dictionary-like text
+ *   run        long runs of a single letter, with and without one odd letter
+ *   consonant  all-consonant strings of growing length
+ *   rare       strings built only from rare letters, digits and punctuation
+ *   short      every one- and two-letter query (largest posting lists)
+ *
+ * The slowest queries are re-run through symspell_lookup_explain() to show
+ * the internal counters behind them (deletes generated, table probes,
+ * posting entries visited, candidates accepted). With --max-latency-us the
+ * run fails when any query exceeds the bound, so a worst-case regression
+ * shows up before it reaches production. --verify-threads N times the
+ * queries with N verification helpers (symspell_set_verify_threads).
+ *
+ * Corpus file format: category<TAB>query, one per line.
+ */
+
+#define _GNU_SOURCE
+#define _POSIX_C_SOURCE 200809L
+
+#include "symspell.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define SYMSPELL_MAX_TERM_LENGTH 128
+#define MAX_LINE_BUFFER 8192
+#define EDIT_DISTANCE 2
+#define PREFIX_LENGTH 7
+#define MAX_SUGGESTIONS 5
+#define MAX_CATEGORY 16
+#define DEFAULT_SLOWEST 10
+#define DEFAULT_SEED 0x5eed5eedULL
+#define RANDOM_PER_CATEGORY 200
+#define VERIFY_MIN_WORDS 2000
+#define MAX_QUERY_LENGTH (SYMSPELL_MAX_TERM_LENGTH - 1)
+
+typedef struct {
+    char category[MAX_CATEGORY];
+    char query[SYMSPELL_MAX_TERM_LENGTH];
+    uint64_t latency_ns;
+} torture_query_t;
+
+typedef struct {
+    torture_query_t* items;
+    size_t count;
+    size_t capacity;
+} torture_corpus_t;
+
+static const char CONSONANTS[] = "bcdfghjklmnpqrstvwxz";
+static const char RARE_CHARS[] = "qxzj0123456789'-_.";
+static const char COMMON_LETTERS[] = "etaoinshrdlu";
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/* xorshift64*: deterministic across platforms, unlike rand() */
+static uint64_t next_random(uint64_t* state) {
+    uint64_t x = *state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    *state = x;
+    return x * 0x2545F4914F6CDD1DULL;
+}
+
+static void random_string(uint64_t* rng, char* out, size_t length,
+                          const char* alphabet, size_t alphabet_size) {
+    for (size_t i = 0; i < length; i++) {
+        out[i] = alphabet[next_random(rng) % alphabet_size];
+    }
+    out[length] = '\0';
+}
+
+static int corpus_add(torture_corpus_t* corpus, const char* category, const char* query) {
+    if (query[0] == '\0') return 1;
+    if (corpus->count == corpus->capacity) {
+        size_t new_cap = corpus->capacity ? corpus->capacity * 2 : 1024;
+        torture_query_t* grown = realloc(corpus->items, new_cap * sizeof(torture_query_t));
+        if (!grown) return 0;
+        corpus->items = grown;
+        corpus->capacity = new_cap;
+    }
+    torture_query_t* q = &corpus->items[corpus->count++];
+    snprintf(q->category, sizeof(q->category), "%s", category);
+    snprintf(q->query, sizeof(q->query), "%s", query);
+    q->latency_ns = 0;
+    return 1;
+}
+
+static int generate_corpus(torture_corpus_t* corpus, uint64_t seed) {
+    uint64_t rng = seed ? seed : DEFAULT_SEED;
+    char buf[SYMSPELL_MAX_TERM_LENGTH];
+    int ok = 1;
+
+    /* long: maximum-length tokens */
+    for (int i = 0; i < RANDOM_PER_CATEGORY && ok; i++) {
+        size_t length = MAX_QUERY_LENGTH - (next_random(&rng) % 32);
+        random_string(&rng, buf, length, "abcdefghijklmnopqrstuvwxyz", 26);
+        ok = corpus_add(corpus, "long", buf);
+    }
+    for (int i = 0; i < RANDOM_PER_CATEGORY / 4 && ok; i++) {
+        random_string(&rng, buf, MAX_QUERY_LENGTH, COMMON_LETTERS, sizeof(COMMON_LETTERS) - 1);
+        ok = corpus_add(corpus, "long", buf);
+    }
+
+    /* run: one letter repeated, plain and with one odd letter inside */
+    for (char c = 'a'; c <= 'z' && ok; c++) {
+        static const size_t lengths[] = {5, 8, 16, 32, 64, MAX_QUERY_LENGTH};
+        for (size_t k = 0; k < sizeof(lengths) / sizeof(lengths[0]) && ok; k++) {
+            memset(buf, c, lengths[k]);
+            buf[lengths[k]] = '\0';
+            ok = corpus_add(corpus, "run", buf);
+            if (ok) {
+                buf[lengths[k] / 2] = (c == 'e') ? 'a' : 'e';
+                ok = corpus_add(corpus, "run", buf);
+            }
+        }
+    }
+
+    /* consonant: no vowels, lengths 5..40 */
+    for (int i = 0; i < RANDOM_PER_CATEGORY && ok; i++) {
+        size_t length = 5 + (size_t)(next_random(&rng) % 36);
+        random_string(&rng, buf, length, CONSONANTS, sizeof(CONSONANTS) - 1);
+        ok = corpus_add(corpus, "consonant", buf);
+    }
+
+    /* rare: characters that are rare or absent in the dictionary */
+    for (int i = 0; i < RANDOM_PER_CATEGORY && ok; i++) {
+        size_t length = 3 + (size_t)(next_random(&rng) % 30);
+        random_string(&rng, buf, length, RARE_CHARS, sizeof(RARE_CHARS) - 1);
+        ok = corpus_add(corpus, "rare", buf);
+    }
+
+    /* short: every one- and two-letter query */
+    for (char a = 'a'; a <= 'z' && ok; a++) {
+        buf[0] = a;
+        buf[1] = '\0';
+        ok = corpus_add(corpus, "short", buf);
+        for (char b = 'a'; b <= 'z' && ok; b++) {
+            buf[1] = b;
+            buf[2] = '\0';
+            ok = corpus_add(corpus, "short", buf);
+        }
+    }
+    return ok;
+}
+
+static int read_corpus(torture_corpus_t* corpus, const char* filepath) {
+    FILE* fp = fopen(filepath, "r");
+    if (!fp) {
+        fprintf(stderr, "Failed to open corpus: %s\n", filepath);
+        return 0;
+    }
+    char line[MAX_LINE_BUFFER];
+    while (fgets(line, sizeof(line), fp)) {
+        line[strcspn(line, "\r\n")] = '\0';
+        char* tab = strchr(line, '\t');
+        if (!tab) continue;
+        *tab = '\0';
+        if (!corpus_add(corpus, line, tab + 1)) {
+            fclose(fp);
+            return 0;
+        }
+    }
+    fclose(fp);
+    return 1;
+}
+
+static int write_corpus(const torture_corpus_t* corpus, const char* filepath) {
+    FILE* fp = fopen(filepath, "w");
+    if (!fp) {
+        fprintf(stderr, "Failed to open %s for writing\n", filepath);
+        return 0;
+    }
+    for (size_t i = 0; i < corpus->count; i++) {
+        fprintf(fp, "%s\t%s\n", corpus->items[i].category, corpus->items[i].query);
+    }
+    fclose(fp);
+    return 1;
+}
+
+static int compare_by_latency_desc(const void* a, const void* b) {
+    const torture_query_t* x = a;
+    const torture_query_t* y = b;
+    return (x->latency_ns < y->latency_ns) - (x->latency_ns > y->latency_ns);
+}
+
+/* Per-category maximum and mean, in corpus order of first appearance */
+static void print_category_summary(const torture_corpus_t* corpus) {
+    char names[16][MAX_CATEGORY];
+    uint64_t max_ns[16] = {0};
+    double sum_ns[16] = {0};
+    size_t counts[16] = {0};
+    int n = 0;
+
+    for (size_t i = 0; i < corpus->count; i++) {
+        const torture_query_t* q = &corpus->items[i];
+        int c = 0;
+        while (c < n && strcmp(names[c], q->category) != 0) c++;
+        if (c == n) {
+            if (n == 16) continue;
+            snprintf(names[n++], MAX_CATEGORY, "%s", q->category);
+        }
+        counts[c]++;
+        sum_ns[c] += (double)q->latency_ns;
+        if (q->latency_ns > max_ns[c]) max_ns[c] = q->latency_ns;
+    }
+
+    printf("--- Latency by Category (µs) ---\n");
+    printf("%-12s %8s %10s %10s\n", "category", "queries", "mean", "max");
+    for (int c = 0; c < n; c++) {
+        printf("%-12s %8zu %10.1f %10.1f\n", names[c], counts[c],
+               sum_ns[c] / (double)counts[c] / 1000.0, (double)max_ns[c] / 1000.0);
+    }
+    printf("\n");
+}
+
+static void print_slowest(const symspell_dict_t* dict, const torture_corpus_t* sorted,
+                          size_t slowest) {
+    printf("--- Slowest Queries ---\n");
+    printf("%10s  %-10s %7s %7s %8s %9s %8s  %s\n", "µs", "category", "deletes",
+           "probes", "postings", "accepted", "result", "query");
+    for (size_t i = 0; i < slowest && i < sorted->count; i++) {
+        const torture_query_t* q = &sorted->items[i];
+        symspell_suggestion_t suggestions[MAX_SUGGESTIONS];
+        symspell_explain_t explain;
+        int count = symspell_lookup_explain(dict, q->query, EDIT_DISTANCE,
+                                            suggestions, MAX_SUGGESTIONS, &explain);
+        printf("%10.1f  %-10s %7zu %7zu %8zu %9zu %8s  %.48s%s\n",
+               (double)q->latency_ns / 1000.0, q->category,
+               explain.delete_count, explain.table_probes + (size_t)explain.exact_probes,
+               explain.postings_visited, explain.accepted,
+               count > 0 ? suggestions[0].term : "(none)",
+               q->query, strlen(q->query) > 48 ? "..." : "");
+        symspell_explain_free(&explain);
+    }
+    printf("\n");
+}
+
+static void usage(const char* prog) {
+    fprintf(stderr, "Usage: %s <dictionary_file> [options]\n", prog);
+    fprintf(stderr, "  --corpus FILE          Read queries (category<TAB>query) instead of generating\n");
+    fprintf(stderr, "  --generate FILE        Write the generated corpus and exit\n");
+    fprintf(stderr, "  --seed N               Generator seed (default fixed)\n");
+    fprintf(stderr, "  --slowest N            Slowest queries to explain (default %d)\n", DEFAULT_SLOWEST);
+    fprintf(stderr, "  --max-latency-us N     Fail if any query takes longer\n");
+    fprintf(stderr, "  --verify-threads N     Verification helpers for lookups reaching %d+ words\n",
+            VERIFY_MIN_WORDS);
+}
+
+int main(int argc, char* argv[]) {
+    const char* dict_path = NULL;
+    const char* corpus_path = NULL;
+    const char* generate_path = NULL;
+    uint64_t seed = DEFAULT_SEED;
+    size_t slowest = DEFAULT_SLOWEST;
+    double max_latency_us = 0;
+    int verify_threads = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (argv[i][0] != '-') {
+            dict_path = argv[i];
+            continue;
+        }
+        if (i + 1 >= argc) {
+            usage(argv[0]);
+            return 1;
+        }
+        if (strcmp(argv[i], "--corpus") == 0) {
+            corpus_path = argv[++i];
+        } else if (strcmp(argv[i], "--generate") == 0) {
+            generate_path = argv[++i];
+        } else if (strcmp(argv[i], "--seed") == 0) {
+            seed = strtoull(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "--slowest") == 0) {
+            slowest = (size_t)atol(argv[++i]);
+        } else if (strcmp(argv[i], "--max-latency-us") == 0) {
+            max_latency_us = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--verify-threads") == 0) {
+            verify_threads = atoi(argv[++i]);
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    torture_corpus_t corpus = {0};
+    int ok = corpus_path ? read_corpus(&corpus, corpus_path) : generate_corpus(&corpus, seed);
+    if (!ok) {
+        free(corpus.items);
+        return 1;
+    }
+    if (generate_path) {
+        ok = write_corpus(&corpus, generate_path);
+        if (ok) printf("Wrote %zu queries to %s\n", corpus.count, generate_path);
+        free(corpus.items);
+        return ok ? 0 : 1;
+    }
+    if (!dict_path) {
+        usage(argv[0]);
+        free(corpus.items);
+        return 1;
+    }
+
+    symspell_dict_t* dict = symspell_create(EDIT_DISTANCE, PREFIX_LENGTH);
+    if (!dict || !symspell_load_dictionary(dict, dict_path, 0, 1)) {
+        fprintf(stderr, "Failed to load dictionary\n");
+        if (dict) symspell_destroy(dict);
+        free(corpus.items);
+        return 1;
+    }
+    if (verify_threads > 0 && !symspell_set_verify_threads(dict, verify_threads, VERIFY_MIN_WORDS)) {
+        symspell_destroy(dict);
+        free(corpus.items);
+        return 1;
+    }
+
+    printf("\nRunning %zu adversarial queries\n\n", corpus.count);
+    size_t over_bound = 0;
+    for (size_t i = 0; i < corpus.count; i++) {
+        torture_query_t* q = &corpus.items[i];
+        symspell_suggestion_t suggestions[MAX_SUGGESTIONS];
+        uint64_t start = now_ns();
+        symspell_lookup(dict, q->query, EDIT_DISTANCE, suggestions, MAX_SUGGESTIONS);
+        q->latency_ns = now_ns() - start;
+        if (max_latency_us > 0 && (double)q->latency_ns / 1000.0 > max_latency_us) over_bound++;
+    }
+
+    print_category_summary(&corpus);
+
+    qsort(corpus.items, corpus.count, sizeof(torture_query_t), compare_by_latency_desc);
+    print_slowest(dict, &corpus, slowest);
+
+    int status = 0;
+    if (max_latency_us > 0) {
+        if (over_bound > 0) {
+            printf("FAIL: %zu queries over the %.0f µs bound (worst %.1f µs)\n",
+                   over_bound, max_latency_us, (double)corpus.items[0].latency_ns / 1000.0);
+            status = 1;
+        } else {
+            printf("PASS: all queries within %.0f µs (worst %.1f µs)\n", max_latency_us,
+                   corpus.count ? (double)corpus.items[0].latency_ns / 1000.0 : 0.0);
+        }
+    }
+
+    symspell_destroy(dict);
+    free(corpus.items);
+    return status;
+}